@@ -0,0 +1,14 @@
+#ifndef LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_ALLOCATIONS_HH_
+#define LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_ALLOCATIONS_HH_
+
+#include <cstdint>
+
+// The program linking `lib/Allocations.o` replaces the global `operator new`
+// and `operator delete` with versions which count the allocations made (all
+// forms: plain, aligned and non-throwing, of objects and of arrays), once
+// counting has been started. It is not part of the library, which must leave
+// the allocator of the program using it alone.
+void count_allocations(void);
+std::uint64_t total_allocations(bool bytes);
+
+#endif  // LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_ALLOCATIONS_HH_
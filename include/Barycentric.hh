@@ -0,0 +1,26 @@
+#ifndef LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_BARYCENTRIC_HH_
+#define LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_BARYCENTRIC_HH_
+
+#include <cstddef>
+#include <vector>
+
+#include "Cancellation.hh"
+
+// Interpolating polynomial in barycentric form. Unlike the coefficients of
+// `Polynomial`, this remains accurate for many points.
+class Barycentric
+{
+    public:
+    std::vector<double> xcoords, ycoords, weights;
+
+    public:
+    Barycentric(std::vector<double> const& xcoords, std::vector<double> const& ycoords,
+                Cancellation const* cancellation=nullptr);
+    double operator()(double x) const;
+    void evaluate(double const* xcoords, double* ycoords, std::size_t count) const;
+};
+
+std::vector<double> barycentric_weights(std::vector<double> const& xcoords, std::size_t num_of_threads=0,
+                                        Cancellation const* cancellation=nullptr);
+
+#endif  // LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_BARYCENTRIC_HH_
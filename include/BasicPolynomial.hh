@@ -0,0 +1,277 @@
+#ifndef LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_BASICPOLYNOMIAL_HH_
+#define LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_BASICPOLYNOMIAL_HH_
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#include "Cancellation.hh"
+
+// Polynomial whose coefficients, starting with the constant term, are of any
+// type with the arithmetic operators and a constructor from `int`, such as
+// `Fraction`. `Polynomial`, whose coefficients are `double`, derives from
+// this, and has faster and more accurate ways to construct and multiply.
+template<typename Scalar>
+class BasicPolynomial: public std::vector<Scalar>
+{
+    public:
+    BasicPolynomial();
+    BasicPolynomial(std::initializer_list<Scalar> const& list);
+    BasicPolynomial(std::vector<Scalar> const& vector);
+    BasicPolynomial(std::vector<Scalar> const& xcoords, std::vector<Scalar> const& ycoords,
+                    Cancellation const* cancellation=nullptr);
+    void trim(void);
+    Scalar operator()(Scalar const& x) const;
+};
+
+/******************************************************************************
+ * Constructors.
+ *****************************************************************************/
+template<typename Scalar>
+BasicPolynomial<Scalar>::BasicPolynomial()
+{
+}
+
+template<typename Scalar>
+BasicPolynomial<Scalar>::BasicPolynomial(std::initializer_list<Scalar> const& list)
+: std::vector<Scalar>(list)
+{
+}
+
+template<typename Scalar>
+BasicPolynomial<Scalar>::BasicPolynomial(std::vector<Scalar> const& vector)
+: std::vector<Scalar>(vector)
+{
+}
+
+/******************************************************************************
+ * Constructor. Given the x- and y-coordinates of a set of points, find the
+ * interpolating polynomial which passes through all of them, from the divided
+ * differences of its Newton form. If the two arguments are of different
+ * sizes, the extra coordinates present at the end of the larger argument are
+ * ignored. With exact coefficients, the result is exact.
+ *
+ * @param xcoords
+ * @param ycoords
+ * @param cancellation Polled once per divided difference.
+ *****************************************************************************/
+template<typename Scalar>
+BasicPolynomial<Scalar>::BasicPolynomial(std::vector<Scalar> const& xcoords, std::vector<Scalar> const& ycoords,
+                                         Cancellation const* cancellation)
+{
+    std::size_t num_of_points = std::min(xcoords.size(), ycoords.size());
+    if(num_of_points <= 1)
+    {
+        throw std::invalid_argument("At least two points are required for interpolation.");
+    }
+    std::vector<Scalar> differences(ycoords.begin(), ycoords.begin() + num_of_points);
+    for(std::size_t k = 1; k < num_of_points; ++k)
+    {
+        check(cancellation);
+        for(std::size_t i = num_of_points - 1; i >= k; --i)
+        {
+            Scalar spacing = xcoords[i] - xcoords[i - k];
+            if(spacing == Scalar(0))
+            {
+                throw std::invalid_argument("Expected distinct x-coordinates.");
+            }
+            differences[i] = (differences[i] - differences[i - 1]) / spacing;
+        }
+    }
+
+    // Expand the nested form, from the innermost factor outwards.
+    this->assign(1, differences.back());
+    for(std::size_t k = num_of_points - 1; k-- > 0;)
+    {
+        check(cancellation);
+        this->insert(this->begin(), differences[k]);
+        for(std::size_t i = 0; i + 1 < this->size(); ++i)
+        {
+            (*this)[i] -= xcoords[k] * (*this)[i + 1];
+        }
+    }
+    this->trim();
+}
+
+/******************************************************************************
+ * Remove trailing zero coefficients.
+ *****************************************************************************/
+template<typename Scalar>
+void BasicPolynomial<Scalar>::trim(void)
+{
+    while(!this->empty() && this->back() == Scalar(0))
+    {
+        this->pop_back();
+    }
+}
+
+/******************************************************************************
+ * Evaluate the polynomial using Horner's method.
+ *
+ * @param x
+ *
+ * @return Value of the polynomial at `x`.
+ *****************************************************************************/
+template<typename Scalar>
+Scalar BasicPolynomial<Scalar>::operator()(Scalar const& x) const
+{
+    Scalar result(0);
+    for(auto it = this->crbegin(); it != this->crend(); ++it)
+    {
+        result = result * x + *it;
+    }
+    return result;
+}
+
+/******************************************************************************
+ * Print a polynomial.
+ *
+ * @param ostream Output stream.
+ * @param p Polynomial.
+ *
+ * @return The output stream.
+ *****************************************************************************/
+template<typename Scalar>
+std::ostream& operator<<(std::ostream& ostream, BasicPolynomial<Scalar> const& p)
+{
+    char const* delimiter = "";
+    ostream << "[";
+    for(auto const& coefficient: p)
+    {
+        ostream << delimiter << coefficient;
+        delimiter = ", ";
+    }
+    ostream << "]";
+    return ostream;
+}
+
+/******************************************************************************
+ * Add or subtract two polynomials in-place.
+ *
+ * @param p
+ * @param q
+ *****************************************************************************/
+template<typename Scalar>
+void operator+=(BasicPolynomial<Scalar>& p, BasicPolynomial<Scalar> const& q)
+{
+    if(p.size() < q.size())
+    {
+        p.resize(q.size(), Scalar(0));
+    }
+    for(std::size_t i = 0; i < q.size(); ++i)
+    {
+        p[i] += q[i];
+    }
+    p.trim();
+}
+
+template<typename Scalar>
+void operator-=(BasicPolynomial<Scalar>& p, BasicPolynomial<Scalar> const& q)
+{
+    if(p.size() < q.size())
+    {
+        p.resize(q.size(), Scalar(0));
+    }
+    for(std::size_t i = 0; i < q.size(); ++i)
+    {
+        p[i] -= q[i];
+    }
+    p.trim();
+}
+
+/******************************************************************************
+ * Multiply two polynomials using the schoolbook algorithm.
+ *
+ * @param p
+ * @param q
+ *
+ * @return Product.
+ *****************************************************************************/
+template<typename Scalar>
+BasicPolynomial<Scalar> operator*(BasicPolynomial<Scalar> const& p, BasicPolynomial<Scalar> const& q)
+{
+    BasicPolynomial<Scalar> result;
+    if(p.empty() || q.empty())
+    {
+        return result;
+    }
+    result.assign(p.size() + q.size() - 1, Scalar(0));
+    for(std::size_t i = 0; i < p.size(); ++i)
+    {
+        for(std::size_t j = 0; j < q.size(); ++j)
+        {
+            result[i + j] += p[i] * q[j];
+        }
+    }
+    result.trim();
+    return result;
+}
+
+/******************************************************************************
+ * Multiply or divide a polynomial by a number in-place.
+ *
+ * @param p
+ * @param d
+ *****************************************************************************/
+template<typename Scalar>
+void operator*=(BasicPolynomial<Scalar>& p, Scalar const& d)
+{
+    for(auto& coefficient: p)
+    {
+        coefficient *= d;
+    }
+    p.trim();
+}
+
+template<typename Scalar>
+void operator/=(BasicPolynomial<Scalar>& p, Scalar const& d)
+{
+    for(auto& coefficient: p)
+    {
+        coefficient /= d;
+    }
+    p.trim();
+}
+
+template<typename Scalar>
+BasicPolynomial<Scalar> operator+(BasicPolynomial<Scalar> const& p, BasicPolynomial<Scalar> const& q)
+{
+    BasicPolynomial<Scalar> result = p;
+    result += q;
+    return result;
+}
+
+template<typename Scalar>
+BasicPolynomial<Scalar> operator-(BasicPolynomial<Scalar> const& p, BasicPolynomial<Scalar> const& q)
+{
+    BasicPolynomial<Scalar> result = p;
+    result -= q;
+    return result;
+}
+
+template<typename Scalar>
+void operator*=(BasicPolynomial<Scalar>& p, BasicPolynomial<Scalar> const& q)
+{
+    p = p * q;
+}
+
+template<typename Scalar>
+BasicPolynomial<Scalar> operator*(BasicPolynomial<Scalar> const& p, Scalar const& d)
+{
+    BasicPolynomial<Scalar> result = p;
+    result *= d;
+    return result;
+}
+
+template<typename Scalar>
+BasicPolynomial<Scalar> operator/(BasicPolynomial<Scalar> const& p, Scalar const& d)
+{
+    BasicPolynomial<Scalar> result = p;
+    result /= d;
+    return result;
+}
+
+#endif  // LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_BASICPOLYNOMIAL_HH_
@@ -0,0 +1,26 @@
+#ifndef LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_BATCH_HH_
+#define LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_BATCH_HH_
+
+#include <cstddef>
+
+// Interpolation of many small independent sets of points, one set per SIMD
+// lane. Arrays are in structure-of-arrays layout: the ith coordinate of the
+// sth set is at index `i * num_of_sets + s`. If `sizes` is `nullptr`, every
+// set has `max_points` points; otherwise, the sth set has `sizes[s]` points
+// (at least 1 and at most `max_points`), and the remaining slots of its
+// column are ignored on input and zeroed on output. Nothing is allocated. If
+// the x-coordinates of a set are not distinct, `std::invalid_argument` is
+// thrown; the results of the sets before it may already have been written.
+
+constexpr std::size_t batch_max_points = 16;
+
+void batch_newton(std::size_t num_of_sets, std::size_t const* sizes, std::size_t max_points,
+                  double const* xcoords, double const* ycoords, double* coefficients);
+void batch_monomial(std::size_t num_of_sets, std::size_t const* sizes, std::size_t max_points,
+                    double const* xcoords, double const* ycoords, double* coefficients);
+void batch_evaluate(std::size_t num_of_sets, std::size_t const* sizes, std::size_t max_points,
+                    double const* xcoords, double const* coefficients, double const* queries, double* results);
+void batch_neville(std::size_t num_of_sets, std::size_t const* sizes, std::size_t max_points,
+                   double const* xcoords, double const* ycoords, double const* queries, double* results);
+
+#endif  // LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_BATCH_HH_
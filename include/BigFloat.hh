@@ -0,0 +1,54 @@
+#ifndef LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_BIGFLOAT_HH_
+#define LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_BIGFLOAT_HH_
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+
+#include "Rational.hh"
+
+// Binary floating-point number with a precision of any number of bits: an
+// integer mantissa of at most that many bits times a power of 2, with an
+// exponent which cannot overflow. The mantissa is odd (or zero), so that each
+// number has one representation. The result of an operation has the larger of
+// the precisions of its operands, and is the exact result correctly rounded
+// (to nearest, ties to even) to that precision. Integers are exact: they have
+// no precision, and do not raise that of a result.
+class BigFloat
+{
+    private:
+    BigInteger mantissa;
+    long long exponent;
+    std::size_t precision;
+    void round(bool inexact=false);
+    static BigFloat divide(BigInteger const& numerator, BigInteger const& denominator, long long exponent,
+                           std::size_t precision);
+
+    public:
+    BigFloat(int value=0);
+    BigFloat(long long value);
+    explicit BigFloat(double value, std::size_t precision=53);
+    BigFloat(Rational const& value, std::size_t precision);
+    std::size_t get_precision(void) const;
+    int sign(void) const;
+    double to_double(void) const;
+    Rational to_rational(void) const;
+    std::string to_string(void) const;
+
+    friend BigFloat operator+(BigFloat const& a, BigFloat const& b);
+    friend BigFloat operator*(BigFloat const& a, BigFloat const& b);
+    friend BigFloat operator/(BigFloat const& a, BigFloat const& b);
+    friend BigFloat operator-(BigFloat const& a);
+    friend bool operator==(BigFloat const& a, BigFloat const& b);
+};
+
+BigFloat operator-(BigFloat const& a, BigFloat const& b);
+void operator+=(BigFloat& a, BigFloat const& b);
+void operator-=(BigFloat& a, BigFloat const& b);
+void operator*=(BigFloat& a, BigFloat const& b);
+void operator/=(BigFloat& a, BigFloat const& b);
+bool operator!=(BigFloat const& a, BigFloat const& b);
+bool operator<(BigFloat const& a, BigFloat const& b);
+std::ostream& operator<<(std::ostream& ostream, BigFloat const& a);
+
+#endif  // LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_BIGFLOAT_HH_
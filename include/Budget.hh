@@ -0,0 +1,38 @@
+#ifndef LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_BUDGET_HH_
+#define LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_BUDGET_HH_
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+
+#include "Tuning.hh"
+
+// Limit on the memory that computations running at the same time may use,
+// according to estimates of their peak footprints made before they start. A
+// computation which does not fit waits until others finish; one which could
+// never fit is rejected.
+class Budget
+{
+    private:
+    std::size_t limit;
+    std::size_t in_use, peak;
+    std::size_t num_of_waits, num_of_rejections;
+    std::mutex mutex;
+    std::condition_variable released;
+
+    public:
+    Budget(std::size_t limit=0);
+    bool acquire(std::size_t bytes);
+    void release(std::size_t bytes);
+    std::size_t capacity(void);
+    std::size_t usage(void);
+    std::size_t peak_usage(void);
+    std::size_t waits(void);
+    std::size_t rejections(void);
+};
+
+std::size_t estimate_memory(std::size_t num_of_points, Construction construction, std::size_t num_of_queries=0);
+std::size_t estimate_memory(std::size_t num_of_points, Construction construction, Arithmetic arithmetic,
+                            std::size_t precision, std::size_t num_of_queries=0);
+
+#endif  // LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_BUDGET_HH_
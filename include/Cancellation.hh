@@ -0,0 +1,34 @@
+#ifndef LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_CANCELLATION_HH_
+#define LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_CANCELLATION_HH_
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+
+// Thrown when a computation is abandoned because it was cancelled or its
+// deadline passed.
+class Expired: public std::runtime_error
+{
+    public:
+    using std::runtime_error::runtime_error;
+};
+
+// Token which long computations poll periodically. Any thread may cancel it.
+class Cancellation
+{
+    private:
+    std::atomic<bool> cancelled;
+    std::chrono::steady_clock::time_point deadline;
+
+    public:
+    Cancellation();
+    Cancellation(std::chrono::steady_clock::duration timeout);
+    void cancel(void);
+    bool expired(void) const;
+    void check(void) const;
+};
+
+void check(Cancellation const* cancellation);
+std::chrono::steady_clock::duration to_duration(double timeout);
+
+#endif  // LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_CANCELLATION_HH_
@@ -0,0 +1,77 @@
+#ifndef LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_CHANNEL_HH_
+#define LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_CHANNEL_HH_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// State of a request in shared memory, written by the client except for the
+// fields after `num_of_queries`, which are written by the server.
+struct Descriptor
+{
+    std::atomic<std::uint32_t> state;
+    std::uint32_t num_of_points, num_of_queries;
+    std::uint32_t num_of_coefficients;
+    std::int32_t status;
+    char message[244];
+};
+
+// Request as seen by one process: its descriptor, its size and where its
+// points, queries and results lie in the shared arena. The server must use
+// the size given here, which was checked when the request was received,
+// rather than the one in the descriptor, which the client could change.
+struct Slot
+{
+    std::uint32_t index;
+    Descriptor* descriptor;
+    std::size_t num_of_points, num_of_queries;
+    double* xcoords;
+    double* ycoords;
+    double* queries;
+    double* coefficients;
+    double* values;
+};
+
+// Transport through which processes on the same machine send point sets to a
+// server and receive the results without copying them through a pipe or a
+// socket. It lives in a POSIX shared memory object holding a fixed number of
+// slots, each with room for a request and its results, and two lock-free
+// rings of slot indices: one of free slots and one of submitted requests.
+// Clients write points straight into a free slot and submit it; the server
+// writes the coefficients and the values at the queries into the same slot.
+class Channel
+{
+    private:
+    std::string name;
+    bool owner;
+    std::size_t length;
+    void* base;
+    struct Header* header;
+    struct Cell* free_cells;
+    struct Cell* request_cells;
+    Descriptor* descriptors;
+    double* arena;
+
+    void map(int fd);
+    Slot slot(std::uint32_t index, std::size_t num_of_points, std::size_t num_of_queries) const;
+
+    public:
+    Channel(std::string const& name, std::size_t num_of_slots, std::size_t slot_capacity);
+    Channel(std::string const& name);
+    Channel(Channel const&) = delete;
+    Channel& operator=(Channel const&) = delete;
+    ~Channel();
+    std::size_t capacity(void) const;
+    std::size_t pending(void) const;
+    Slot acquire(std::size_t num_of_points, std::size_t num_of_queries);
+    void submit(Slot const& slot);
+    bool wait(Slot const& slot);
+    void release(Slot const& slot);
+    bool receive(Slot& slot);
+    void respond(Slot const& slot);
+    void close(void);
+    bool closed(void) const;
+};
+
+#endif  // LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_CHANNEL_HH_
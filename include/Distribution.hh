@@ -0,0 +1,14 @@
+#ifndef LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_DISTRIBUTION_HH_
+#define LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_DISTRIBUTION_HH_
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include "Pipeline.hh"
+#include "Processing.hh"
+
+int distribute(std::vector<char const*> const& paths, Options const& options, Pipeline const& pipeline,
+               std::size_t num_of_workers, std::size_t memory_budget, std::function<void(void)> const& publish);
+
+#endif  // LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_DISTRIBUTION_HH_
@@ -0,0 +1,44 @@
+#ifndef LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_DOUBLEDOUBLE_HH_
+#define LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_DOUBLEDOUBLE_HH_
+
+#include <iostream>
+#include <string>
+
+// Floating-point number represented as the unevaluated sum of two `double`s,
+// the smaller no larger than half a unit in the last place of the larger, so
+// that it has about 106 bits of precision, but the range of a `double`. The
+// arithmetic uses error-free transformations of `double` operations; it is
+// not correctly rounded, but the relative error of each operation is a small
+// multiple of 2 to the power -106.
+class DoubleDouble
+{
+    private:
+    double high, low;
+
+    public:
+    DoubleDouble(int value=0);
+    DoubleDouble(double value);
+    DoubleDouble(double high, double low);
+    double get_high(void) const;
+    double get_low(void) const;
+    double to_double(void) const;
+    std::string to_string(void) const;
+
+    friend DoubleDouble operator+(DoubleDouble const& a, DoubleDouble const& b);
+    friend DoubleDouble operator*(DoubleDouble const& a, DoubleDouble const& b);
+    friend DoubleDouble operator/(DoubleDouble const& a, DoubleDouble const& b);
+    friend DoubleDouble operator-(DoubleDouble const& a);
+    friend bool operator==(DoubleDouble const& a, DoubleDouble const& b);
+    friend bool operator<(DoubleDouble const& a, DoubleDouble const& b);
+};
+
+DoubleDouble operator-(DoubleDouble const& a, DoubleDouble const& b);
+void operator+=(DoubleDouble& a, DoubleDouble const& b);
+void operator-=(DoubleDouble& a, DoubleDouble const& b);
+void operator*=(DoubleDouble& a, DoubleDouble const& b);
+void operator/=(DoubleDouble& a, DoubleDouble const& b);
+bool operator!=(DoubleDouble const& a, DoubleDouble const& b);
+DoubleDouble abs(DoubleDouble const& a);
+std::ostream& operator<<(std::ostream& ostream, DoubleDouble const& a);
+
+#endif  // LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_DOUBLEDOUBLE_HH_
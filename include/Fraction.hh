@@ -0,0 +1,51 @@
+#ifndef LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_FRACTION_HH_
+#define LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_FRACTION_HH_
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "Rational.hh"
+
+// Exact rational number, always in lowest terms with a positive denominator.
+// While its numerator and denominator fit in 64 bits, it is stored in them,
+// and arithmetic is done with 128-bit intermediate results, checked for
+// overflow. A result which does not fit is promoted to a `Rational`; one which
+// fits again is demoted. Small integer sequences therefore never leave the
+// fast representation.
+class Fraction
+{
+    private:
+    std::int64_t numerator, denominator;
+    std::shared_ptr<Rational const> big;
+
+    public:
+    Fraction(int value=0);
+    Fraction(long long value);
+    Fraction(long long numerator, long long denominator);
+    explicit Fraction(double value);
+    explicit Fraction(Rational const& value);
+    bool promoted(void) const;
+    int sign(void) const;
+    Rational to_rational(void) const;
+    double to_double(void) const;
+    std::string to_string(void) const;
+
+    friend Fraction operator+(Fraction const& a, Fraction const& b);
+    friend Fraction operator*(Fraction const& a, Fraction const& b);
+    friend Fraction operator-(Fraction const& a);
+    friend Fraction reciprocal(Fraction const& a);
+    friend bool operator==(Fraction const& a, Fraction const& b);
+};
+
+Fraction operator-(Fraction const& a, Fraction const& b);
+Fraction operator/(Fraction const& a, Fraction const& b);
+void operator+=(Fraction& a, Fraction const& b);
+void operator-=(Fraction& a, Fraction const& b);
+void operator*=(Fraction& a, Fraction const& b);
+void operator/=(Fraction& a, Fraction const& b);
+bool operator!=(Fraction const& a, Fraction const& b);
+std::ostream& operator<<(std::ostream& ostream, Fraction const& a);
+
+#endif  // LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_FRACTION_HH_
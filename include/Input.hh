@@ -0,0 +1,38 @@
+#ifndef LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_INPUT_HH_
+#define LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_INPUT_HH_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Contents of an input file. Each line containing two numbers is a point, and
+// each line containing one number is an x-coordinate to evaluate the
+// interpolating polynomial at.
+struct Points
+{
+    std::vector<double> xcoords, ycoords, queries;
+};
+
+// Reads the contents of a file descriptor (a file, a pipe or a terminal) as
+// a sequence of blocks separated by blank lines, handing out each block as
+// soon as it has been read completely.
+class Stream
+{
+    private:
+    int fd;
+    bool eof;
+    std::string buffer;
+    std::size_t consumed, scanned;
+    bool blank;
+
+    public:
+    Stream(int fd);
+    Stream(std::string&& contents);
+    bool next(char const*& begin, char const*& end);
+};
+
+bool read_file(char const* path, std::string& contents);
+void parse_points(char const* begin, char const* end, Points& points);
+void parse_numbers(char const* begin, char const* end, std::vector<double>& numbers);
+
+#endif  // LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_INPUT_HH_
@@ -0,0 +1,40 @@
+#ifndef LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_MEASURE_HH_
+#define LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_MEASURE_HH_
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <limits>
+
+/******************************************************************************
+ * Measure how long a function takes to run. It is run repeatedly for at least
+ * a few milliseconds, and the best of several such trials is taken, so that
+ * the result is not affected by the occasional interruption.
+ *
+ * @param function Function to measure.
+ * @param num_of_trials
+ *
+ * @return Time taken per call, in seconds.
+ *****************************************************************************/
+template<typename Function>
+double measure(Function function, int num_of_trials=3)
+{
+    double best = std::numeric_limits<double>::infinity();
+    for(int trial = 0; trial < num_of_trials; ++trial)
+    {
+        std::size_t calls = 0;
+        auto begin = std::chrono::steady_clock::now();
+        auto end = begin;
+        do
+        {
+            function();
+            ++calls;
+            end = std::chrono::steady_clock::now();
+        }
+        while(end - begin < std::chrono::milliseconds(2));
+        best = std::min(best, std::chrono::duration<double>(end - begin).count() / calls);
+    }
+    return best;
+}
+
+#endif  // LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_MEASURE_HH_
@@ -0,0 +1,103 @@
+#ifndef LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_METRICS_HH_
+#define LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_METRICS_HH_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Tuning.hh"
+
+// Histogram of durations in nanoseconds, with buckets whose widths grow
+// geometrically, as in HdrHistogram: each power of two is split into 16
+// buckets of equal width, so that any value is known to within 1/16 of itself.
+// Only one thread may record into a histogram, but any may read it.
+class Histogram
+{
+    public:
+    static constexpr std::size_t sub_buckets = 16;
+    static constexpr std::size_t num_of_buckets = 64 * sub_buckets;
+
+    private:
+    std::atomic<std::uint64_t> counts[num_of_buckets];
+    std::atomic<std::uint64_t> total, sum;
+
+    public:
+    Histogram();
+    static std::size_t bucket(std::uint64_t value);
+    static std::uint64_t upper_bound(std::size_t bucket);
+    void record(std::uint64_t value);
+    void merge(Histogram const& other);
+    void dump(std::string& out) const;
+    bool load(char const*& position, char const* end);
+    std::uint64_t count(void) const;
+    std::uint64_t total_value(void) const;
+    std::uint64_t count_below(std::size_t bucket) const;
+    std::uint64_t quantile(double fraction) const;
+};
+
+// Counters and latency histograms of a long-running program, exposed in the
+// Prometheus text format. Each thread records into its own shard, without
+// locking; shards are added up only when the metrics are exposed. Values
+// kept elsewhere (such as queue depths) are read through callbacks. What one
+// object recorded can be dumped and merged into another, perhaps in another
+// process.
+class Metrics
+{
+    public:
+    enum Outcome { succeeded, failed, timed_out };
+
+    private:
+    struct Shard
+    {
+        Histogram construction[4][5];
+        Histogram evaluation;
+        std::atomic<std::uint64_t> requests[3];
+        std::atomic<std::uint64_t> points, queries;
+        Shard();
+    };
+    struct Reading
+    {
+        std::string name, help, type, labels;
+        std::function<double(void)> read;
+    };
+    std::uint64_t identity;
+    std::mutex mutex;
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::vector<Reading> readings;
+    std::thread publisher;
+    std::condition_variable stopping;
+    bool stopped;
+
+    Shard& local(void);
+    void add_up(Shard& total);
+
+    public:
+    Metrics();
+    Metrics(Metrics const&) = delete;
+    Metrics& operator=(Metrics const&) = delete;
+    ~Metrics();
+    void record(Construction construction, Arithmetic arithmetic, std::size_t num_of_points,
+                std::chrono::steady_clock::duration elapsed);
+    void record(std::size_t num_of_queries, std::chrono::steady_clock::duration elapsed);
+    void record(Outcome outcome);
+    void gauge(std::string const& name, std::string const& help, std::string const& labels,
+               std::function<double(void)> read);
+    void counter(std::string const& name, std::string const& help, std::string const& labels,
+                 std::function<double(void)> read);
+    std::string expose(void);
+    std::string dump(void);
+    bool merge(std::string const& dump);
+    bool write(char const* path);
+    void publish(char const* path, std::chrono::steady_clock::duration interval);
+    void stop(void);
+};
+
+#endif  // LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_METRICS_HH_
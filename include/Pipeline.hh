@@ -0,0 +1,64 @@
+#ifndef LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_PIPELINE_HH_
+#define LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_PIPELINE_HH_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Budget.hh"
+#include "Processing.hh"
+
+// Writes the results of sets of points from several files, either in the
+// order of the input, each file introduced by its name as `head(1)` does, or
+// in the order they are ready, each introduced by the name of its file and
+// its number in the file.
+struct Writer
+{
+    bool ordered = true;
+    std::size_t count = 0;
+    char const* previous_path = nullptr;
+    int status = EXIT_SUCCESS;
+
+    void write(char const* path, std::size_t set, std::string const& output, std::string const& errors,
+               int status)
+    {
+        if(this->count++ > 0)
+        {
+            std::cout << "\n";
+        }
+        if(!this->ordered)
+        {
+            std::cout << "==> " << path << ", set " << set << " <==\n";
+        }
+        else if(path != this->previous_path)
+        {
+            std::cout << "==> " << path << " <==\n";
+        }
+        this->previous_path = path;
+        std::cout << output;
+        std::cout.flush();
+        std::cerr << errors;
+        if(this->status == EXIT_SUCCESS)
+        {
+            this->status = status;
+        }
+    }
+};
+
+// Settings of the batch pipeline.
+struct Pipeline
+{
+    std::size_t depth = 64;
+    std::size_t num_of_threads = 1;
+    double aging = 1;
+    bool ordered = true;
+    std::size_t coalesce = 64;
+    std::chrono::steady_clock::duration window{};
+};
+
+int batch(std::vector<char const*> const& paths, Options const& options, Pipeline const& pipeline, Budget& budget);
+
+#endif  // LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_PIPELINE_HH_
@@ -1,12 +1,18 @@
 #ifndef LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_POLYNOMIAL_HH_
 #define LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_POLYNOMIAL_HH_
 
+#include <cstddef>
 #include <initializer_list>
 #include <iostream>
 #include <string>
 #include <vector>
 
-class Polynomial: public std::vector<double>
+#include "BasicPolynomial.hh"
+#include "Cancellation.hh"
+#include "DoubleDouble.hh"
+#include "Tuning.hh"
+
+class Polynomial: public BasicPolynomial<double>
 {
     public:
     bool rational = false;
@@ -15,9 +21,20 @@ class Polynomial: public std::vector<double>
     Polynomial();
     Polynomial(std::initializer_list<double> const& list);
     Polynomial(std::vector<double> const& vector);
-    Polynomial(std::vector<double> const& xcoords, std::vector<double> const& ycoords);
+    explicit Polynomial(BasicPolynomial<DoubleDouble> const& extended);
+    Polynomial(std::vector<double> const& xcoords, std::vector<double> const& ycoords,
+               Precision precision=Precision::standard, Cancellation const* cancellation=nullptr);
+    Polynomial(std::vector<double> const& xcoords, std::vector<double> const& ycoords,
+               Construction construction, Cancellation const* cancellation=nullptr);
+    Polynomial(double start, double step, std::vector<double> const& ycoords,
+               Cancellation const* cancellation=nullptr);
     void sanitise(void);
-    double operator()(double x);
+    double residual(std::vector<double> const& xcoords, std::vector<double> const& ycoords) const;
+    std::size_t refine(std::vector<double> const& xcoords, std::vector<double> const& ycoords,
+                       std::size_t max_iterations=4, Cancellation const* cancellation=nullptr);
+    double operator()(double x) const;
+    void evaluate(double const* xcoords, double* ycoords, std::size_t count,
+                  Cancellation const* cancellation=nullptr) const;
 };
 
 std::ostream& operator<<(std::ostream& ostream, Polynomial const& p);
@@ -27,9 +44,24 @@ void operator-=(Polynomial& p, Polynomial const& q);
 Polynomial operator-(Polynomial const& p, Polynomial const& q);
 void operator*=(Polynomial& p, Polynomial const& q);
 Polynomial operator*(Polynomial const& p, Polynomial const& q);
+void operator*=(Polynomial& p, double d);
+Polynomial operator*(Polynomial const& p, double d);
 void operator/=(Polynomial& p, double d);
 Polynomial operator/(Polynomial const& p, double d);
 
+std::vector<Polynomial> interpolate_many(std::vector<double> const& xcoords,
+                                         std::vector<std::vector<double>> const& ycoords,
+                                         Precision precision=Precision::standard,
+                                         Cancellation const* cancellation=nullptr);
+std::vector<Polynomial> interpolate_many(double start, double step, std::vector<std::vector<double>> const& ycoords,
+                                         Cancellation const* cancellation=nullptr);
+
+BasicPolynomial<DoubleDouble> interpolate_extended(std::vector<double> const& xcoords,
+                                                   std::vector<double> const& ycoords,
+                                                   Cancellation const* cancellation=nullptr);
+double rounding_error(BasicPolynomial<DoubleDouble> const& extended, Polynomial const& p,
+                      std::vector<double> const& xcoords);
+
 std::string rationalise(double number, int long long max_denominator=1000000);
 
 #endif  // LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_POLYNOMIAL_HH_
@@ -0,0 +1,54 @@
+#ifndef LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_PROCESSING_HH_
+#define LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_PROCESSING_HH_
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <vector>
+
+#include "Budget.hh"
+#include "Input.hh"
+#include "Metrics.hh"
+#include "Polynomial.hh"
+#include "Trace.hh"
+
+// Exit status when the timeout expires. Same as that of `timeout(1)`.
+#define EXIT_TIMEOUT 124
+
+// Options given on the command line of `sequence`.
+struct Options
+{
+    bool rational = false;
+    std::size_t precision = 0;
+    bool extended = false;
+    std::size_t refinements = 0;
+    bool y_only = false;
+    double start = 1, step = 1;
+    double timeout = 0;
+    std::vector<double> queries;
+};
+
+// Predicted requirements of processing a set of points.
+struct Estimate
+{
+    double cost = 0;
+    std::size_t memory = 0;
+};
+
+// Where the computations are recorded, if anywhere.
+extern Metrics* metrics;
+
+// Where the sets of points are recorded as they arrive, if anywhere.
+extern TraceWriter* trace;
+
+int process(Points& points, Options const& options, std::ostream& out, std::ostream& err,
+            Polynomial* polynomial=nullptr, std::chrono::steady_clock::duration delay={});
+void read_set(char const* begin, char const* end, Options const& options, Points& points);
+void record_request(Points const& points, Options const& options);
+int parse_set(char const* begin, char const* end, std::size_t set, Options const& options, Points& points,
+              std::ostream& err);
+Estimate estimate(Points const& points, Options const& options);
+int admit(Points& points, std::size_t memory, std::size_t set, Options const& options, Budget& budget,
+          std::ostream& out, std::ostream& err);
+
+#endif  // LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_PROCESSING_HH_
@@ -0,0 +1,206 @@
+#ifndef LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_QUEUE_HH_
+#define LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_QUEUE_HH_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <utility>
+
+// Bounded queue which any number of threads may push to and pop from without
+// locking. Each cell carries a sequence number which tells whether it is
+// ready to be written or to be read in the current lap around the buffer.
+template<typename T>
+class Queue
+{
+    private:
+    struct Cell
+    {
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+    std::unique_ptr<Cell[]> cells;
+    std::size_t mask;
+    alignas(64) std::atomic<std::size_t> head;
+    alignas(64) std::atomic<std::size_t> tail;
+
+    static void wait(std::size_t& attempts);
+
+    public:
+    Queue(std::size_t capacity);
+    std::size_t capacity(void) const;
+    std::size_t size(void) const;
+    bool try_push(T& value);
+    bool try_pop(T& value);
+    void push(T value);
+    T pop(void);
+};
+
+/******************************************************************************
+ * Constructor.
+ *
+ * @param capacity Number of items the queue can hold. Rounded up to a power of
+ *     two.
+ *****************************************************************************/
+template<typename T>
+Queue<T>::Queue(std::size_t capacity)
+: head(0), tail(0)
+{
+    std::size_t size = 2;
+    while(size < capacity)
+    {
+        size *= 2;
+    }
+    this->cells = std::make_unique<Cell[]>(size);
+    this->mask = size - 1;
+    for(std::size_t i = 0; i < size; ++i)
+    {
+        this->cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+/******************************************************************************
+ * @return Number of items the queue can hold.
+ *****************************************************************************/
+template<typename T>
+std::size_t Queue<T>::capacity(void) const
+{
+    return this->mask + 1;
+}
+
+/******************************************************************************
+ * @return Number of items in the queue. Only approximate if other threads are
+ *     pushing or popping.
+ *****************************************************************************/
+template<typename T>
+std::size_t Queue<T>::size(void) const
+{
+    std::size_t tail = this->tail.load(std::memory_order_relaxed);
+    std::size_t head = this->head.load(std::memory_order_relaxed);
+    return head > tail ? head - tail : 0;
+}
+
+/******************************************************************************
+ * Back off while waiting for the queue to change: spin briefly, then yield,
+ * then sleep.
+ *
+ * @param attempts Number of times waited so far. Incremented.
+ *****************************************************************************/
+template<typename T>
+void Queue<T>::wait(std::size_t& attempts)
+{
+    ++attempts;
+    if(attempts < 64)
+    {
+        return;
+    }
+    if(attempts < 128)
+    {
+        std::this_thread::yield();
+        return;
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(50));
+}
+
+/******************************************************************************
+ * Push an item if there is room.
+ *
+ * @param value Item. Moved from if it was pushed.
+ *
+ * @return `true` if the item was pushed, `false` if the queue was full.
+ *****************************************************************************/
+template<typename T>
+bool Queue<T>::try_push(T& value)
+{
+    std::size_t position = this->head.load(std::memory_order_relaxed);
+    while(true)
+    {
+        Cell& cell = this->cells[position & this->mask];
+        std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        if(sequence == position)
+        {
+            if(this->head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                cell.value = std::move(value);
+                cell.sequence.store(position + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if(sequence < position)
+        {
+            return false;
+        }
+        else
+        {
+            position = this->head.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+/******************************************************************************
+ * Pop an item if there is one.
+ *
+ * @param value Variable to move the item into.
+ *
+ * @return `true` if an item was popped, `false` if the queue was empty.
+ *****************************************************************************/
+template<typename T>
+bool Queue<T>::try_pop(T& value)
+{
+    std::size_t position = this->tail.load(std::memory_order_relaxed);
+    while(true)
+    {
+        Cell& cell = this->cells[position & this->mask];
+        std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        if(sequence == position + 1)
+        {
+            if(this->tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                value = std::move(cell.value);
+                cell.sequence.store(position + this->mask + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if(sequence < position + 1)
+        {
+            return false;
+        }
+        else
+        {
+            position = this->tail.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+/******************************************************************************
+ * Push an item, waiting while the queue is full.
+ *
+ * @param value Item.
+ *****************************************************************************/
+template<typename T>
+void Queue<T>::push(T value)
+{
+    for(std::size_t attempts = 0; !this->try_push(value);)
+    {
+        wait(attempts);
+    }
+}
+
+/******************************************************************************
+ * Pop an item, waiting while the queue is empty.
+ *
+ * @return Item.
+ *****************************************************************************/
+template<typename T>
+T Queue<T>::pop(void)
+{
+    T value;
+    for(std::size_t attempts = 0; !this->try_pop(value);)
+    {
+        wait(attempts);
+    }
+    return value;
+}
+
+#endif  // LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_QUEUE_HH_
@@ -0,0 +1,88 @@
+#ifndef LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_RATIONAL_HH_
+#define LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_RATIONAL_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Cancellation.hh"
+
+// Integer of any size, stored as its sign and the 32-bit limbs of its
+// magnitude, least significant first, with no leading zero limbs.
+class BigInteger
+{
+    private:
+    bool negative;
+    std::vector<std::uint32_t> limbs;
+
+    public:
+    BigInteger(long long value=0);
+    int sign(void) const;
+    bool is_zero(void) const;
+    std::size_t bit_length(void) const;
+    std::size_t trailing_zeros(void) const;
+    BigInteger operator-(void) const;
+    BigInteger abs(void) const;
+    double to_double(void) const;
+    long long to_long_long(void) const;
+    std::string to_string(void) const;
+
+    friend int compare(BigInteger const& a, BigInteger const& b);
+    friend BigInteger operator+(BigInteger const& a, BigInteger const& b);
+    friend BigInteger operator-(BigInteger const& a, BigInteger const& b);
+    friend BigInteger operator*(BigInteger const& a, BigInteger const& b);
+    friend void divide(BigInteger const& a, BigInteger const& b, BigInteger& quotient, BigInteger& remainder);
+    friend BigInteger operator<<(BigInteger const& a, std::size_t bits);
+    friend BigInteger operator>>(BigInteger const& a, std::size_t bits);
+    friend BigInteger gcd(BigInteger const& a, BigInteger const& b);
+};
+
+int compare(BigInteger const& a, BigInteger const& b);
+void divide(BigInteger const& a, BigInteger const& b, BigInteger& quotient, BigInteger& remainder);
+BigInteger operator/(BigInteger const& a, BigInteger const& b);
+BigInteger operator%(BigInteger const& a, BigInteger const& b);
+bool operator==(BigInteger const& a, BigInteger const& b);
+bool operator!=(BigInteger const& a, BigInteger const& b);
+bool operator<(BigInteger const& a, BigInteger const& b);
+
+// Exact rational number, always in lowest terms with a positive denominator.
+class Rational
+{
+    private:
+    BigInteger numerator, denominator;
+
+    public:
+    Rational(int value=0);
+    Rational(long long value);
+    Rational(BigInteger const& numerator, BigInteger const& denominator=1);
+    explicit Rational(double value);
+    BigInteger const& get_numerator(void) const;
+    BigInteger const& get_denominator(void) const;
+    int sign(void) const;
+    double to_double(void) const;
+    std::string to_string(void) const;
+
+    friend Rational operator+(Rational const& a, Rational const& b);
+    friend Rational operator*(Rational const& a, Rational const& b);
+    friend Rational operator-(Rational const& a);
+    friend Rational reciprocal(Rational const& a);
+};
+
+Rational operator-(Rational const& a, Rational const& b);
+Rational operator/(Rational const& a, Rational const& b);
+void operator+=(Rational& a, Rational const& b);
+void operator-=(Rational& a, Rational const& b);
+void operator*=(Rational& a, Rational const& b);
+void operator/=(Rational& a, Rational const& b);
+bool operator==(Rational const& a, Rational const& b);
+bool operator!=(Rational const& a, Rational const& b);
+bool operator<(Rational const& a, Rational const& b);
+
+std::uint64_t binary_gcd(std::uint64_t u, std::uint64_t v);
+
+std::vector<Rational> interpolate_exactly(std::vector<double> const& xcoords, std::vector<double> const& ycoords,
+                                          Cancellation const* cancellation=nullptr);
+Rational evaluate_exactly(std::vector<double> const& xcoords, std::vector<double> const& ycoords, double x);
+
+#endif  // LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_RATIONAL_HH_
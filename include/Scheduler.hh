@@ -0,0 +1,165 @@
+#ifndef LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_SCHEDULER_HH_
+#define LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_SCHEDULER_HH_
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// Bounded queue which hands out the item predicted to be the cheapest first
+// (shortest job first). To prevent expensive items from starving, an item's
+// priority improves by `aging` seconds of predicted cost for every second it
+// waits. This is the same as ordering items by their predicted cost plus their
+// arrival time scaled by `aging`, which does not change while they wait, so
+// that a heap suffices.
+template<typename T>
+class Scheduler
+{
+    private:
+    struct Entry
+    {
+        double key;
+        std::size_t order;
+        T value;
+    };
+    std::vector<Entry> heap;
+    std::size_t capacity;
+    double aging;
+    std::size_t count;
+    std::chrono::steady_clock::time_point epoch;
+    std::mutex mutex;
+    std::condition_variable not_empty, not_full;
+
+    static bool later(Entry const& a, Entry const& b);
+
+    public:
+    Scheduler(std::size_t capacity, double aging=1);
+    std::size_t size(void);
+    void push(T value, double cost);
+    T pop(void);
+    template<typename Predicate>
+    void take(Predicate matches, std::size_t limit, std::chrono::steady_clock::duration window,
+              std::vector<T>& taken);
+};
+
+/******************************************************************************
+ * Constructor.
+ *
+ * @param capacity Number of items the scheduler can hold.
+ * @param aging Seconds of predicted cost an item's priority improves by for
+ *     every second it waits. If 0, items are handed out strictly in order of
+ *     cost.
+ *****************************************************************************/
+template<typename T>
+Scheduler<T>::Scheduler(std::size_t capacity, double aging)
+: capacity(std::max<std::size_t>(capacity, 1)), aging(aging), count(0), epoch(std::chrono::steady_clock::now())
+{
+}
+
+/******************************************************************************
+ * Order entries for the heap. Entries with equal keys are handed out in the
+ * order they arrived.
+ *
+ * @param a
+ * @param b
+ *
+ * @return `true` if `a` must be handed out after `b`, else `false`.
+ *****************************************************************************/
+template<typename T>
+bool Scheduler<T>::later(Entry const& a, Entry const& b)
+{
+    return a.key > b.key || (a.key == b.key && a.order > b.order);
+}
+
+/******************************************************************************
+ * @return Number of items waiting.
+ *****************************************************************************/
+template<typename T>
+std::size_t Scheduler<T>::size(void)
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->heap.size();
+}
+
+/******************************************************************************
+ * Add an item, waiting while the scheduler is full.
+ *
+ * @param value Item.
+ * @param cost Predicted cost of the item, in seconds. Items with infinite cost
+ *     are handed out after all others.
+ *****************************************************************************/
+template<typename T>
+void Scheduler<T>::push(T value, double cost)
+{
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->not_full.wait(lock, [this]{ return this->heap.size() < this->capacity; });
+    double arrival = std::chrono::duration<double>(std::chrono::steady_clock::now() - this->epoch).count();
+    this->heap.push_back(Entry{cost + this->aging * arrival, this->count++, std::move(value)});
+    std::push_heap(this->heap.begin(), this->heap.end(), later);
+    lock.unlock();
+
+    // All waiting threads are woken, because one of them may be waiting in
+    // `take` for an item which this is not.
+    this->not_empty.notify_all();
+}
+
+/******************************************************************************
+ * Remove the item with the highest priority, waiting while the scheduler is
+ * empty.
+ *
+ * @return Item.
+ *****************************************************************************/
+template<typename T>
+T Scheduler<T>::pop(void)
+{
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->not_empty.wait(lock, [this]{ return !this->heap.empty(); });
+    std::pop_heap(this->heap.begin(), this->heap.end(), later);
+    T value = std::move(this->heap.back().value);
+    this->heap.pop_back();
+    lock.unlock();
+    this->not_full.notify_one();
+    return value;
+}
+
+/******************************************************************************
+ * Remove the items satisfying a condition, regardless of their priorities,
+ * waiting a short while for more to arrive.
+ *
+ * @param matches Function which takes an item and tells whether it must be
+ *     removed.
+ * @param limit Largest number of items to have in `taken`.
+ * @param window Time to wait for more items while there are fewer than
+ *     `limit`.
+ * @param taken Vector to append the items to.
+ *****************************************************************************/
+template<typename T>
+template<typename Predicate>
+void Scheduler<T>::take(Predicate matches, std::size_t limit, std::chrono::steady_clock::duration window,
+                        std::vector<T>& taken)
+{
+    auto deadline = std::chrono::steady_clock::now() + window;
+    std::unique_lock<std::mutex> lock(this->mutex);
+    while(taken.size() < limit)
+    {
+        auto it = std::partition(this->heap.begin(), this->heap.end(),
+                                 [&](Entry const& entry){ return !matches(entry.value); });
+        std::size_t count = std::min<std::size_t>(this->heap.end() - it, limit - taken.size());
+        for(auto jt = it; jt != it + count; ++jt)
+        {
+            taken.push_back(std::move(jt->value));
+        }
+        this->heap.erase(it, it + count);
+        std::make_heap(this->heap.begin(), this->heap.end(), later);
+        this->not_full.notify_all();
+        if(taken.size() >= limit || this->not_empty.wait_until(lock, deadline) == std::cv_status::timeout)
+        {
+            break;
+        }
+    }
+}
+
+#endif  // LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_SCHEDULER_HH_
@@ -0,0 +1,11 @@
+#ifndef LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_SERVER_HH_
+#define LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_SERVER_HH_
+
+#include <cstddef>
+
+#include "Processing.hh"
+
+int serve(char const* name, std::size_t num_of_slots, std::size_t slot_capacity, Options const& options,
+          std::size_t num_of_threads);
+
+#endif  // LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_SERVER_HH_
@@ -0,0 +1,59 @@
+#ifndef LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_TRACE_HH_
+#define LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_TRACE_HH_
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Request to interpolate a set of points and evaluate the interpolating
+// polynomial, as recorded in a trace. In the y-only mode, the x-coordinates
+// are `start`, `start + step` and so on, and `xcoords` is empty.
+struct Request
+{
+    std::uint64_t time = 0;
+    bool y_only = false;
+    double start = 1, step = 1;
+    std::vector<double> xcoords, ycoords, queries;
+};
+
+// Records requests in a binary file as they arrive, each with the time since
+// recording started, in nanoseconds. Any thread may record. Whether the whole
+// trace could be written is known only once it is closed.
+class TraceWriter
+{
+    private:
+    std::FILE* file;
+    std::string path;
+    bool failed;
+    std::mutex mutex;
+    std::chrono::steady_clock::time_point epoch;
+    void write(Request const& request, std::uint64_t time);
+
+    public:
+    TraceWriter(char const* path);
+    TraceWriter(TraceWriter const&) = delete;
+    TraceWriter& operator=(TraceWriter const&) = delete;
+    ~TraceWriter();
+    void record(Request const& request);
+    void record(Request const& request, std::uint64_t time);
+    void close(void);
+};
+
+// Reads requests back from a file written by `TraceWriter`.
+class TraceReader
+{
+    private:
+    std::FILE* file;
+
+    public:
+    TraceReader(char const* path);
+    TraceReader(TraceReader const&) = delete;
+    TraceReader& operator=(TraceReader const&) = delete;
+    ~TraceReader();
+    bool next(Request& request);
+};
+
+#endif  // LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_TRACE_HH_
@@ -0,0 +1,85 @@
+#ifndef LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_TUNING_HH_
+#define LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_TUNING_HH_
+
+#include <cstddef>
+#include <vector>
+
+// Structure of the x-coordinates of a set of points.
+enum class Nodes
+{
+    arbitrary,
+    equispaced,
+    chebyshev,
+};
+
+// Accuracy requested of the interpolating polynomial. With `extended`, it is
+// constructed using double-double arithmetic, and only then rounded.
+enum class Precision
+{
+    standard,
+    high,
+    extended,
+};
+
+// Numbers the interpolating polynomial is constructed with: `double`,
+// `DoubleDouble` (see `interpolate_extended`), `BigFloat` or `Fraction`.
+enum class Arithmetic
+{
+    standard,
+    double_double,
+    big_float,
+    rational,
+};
+
+// Algorithms which can construct the interpolating polynomial.
+enum class Construction
+{
+    lagrange,
+    newton,
+    newton_leja,
+    forward_difference,
+    bjorck_pereyra,
+};
+
+// Algorithms which can multiply two polynomials.
+enum class Multiplication
+{
+    schoolbook,
+    karatsuba,
+};
+
+// Thresholds used to choose among the above algorithms, and coefficients of
+// the model which predicts how long they take (see `predict_cost`). The
+// defaults below are overridden by the tuning file written by the autotuner,
+// if present.
+struct Tuning
+{
+    std::size_t newton_min_points = 0;
+    std::size_t karatsuba_min_size = 48;
+    std::size_t parallel_weights_min_points = 2048;
+    double node_tolerance = 1e-13;
+    double cost_overhead = 1.3e-6;
+    double cost_lagrange = 1.5e-9;
+    double cost_newton = 8.7e-9;
+    double cost_newton_leja = 1.6e-8;
+    double cost_forward_difference = 2.3e-9;
+    double cost_bjorck_pereyra = 2.7e-9;
+    double cost_evaluation = 1.6e-9;
+    double cost_double_double = 1.1e-7;
+    double cost_big_float = 1.4e-6;
+    double cost_rational = 2.5e-9;
+};
+
+Tuning& tuning(void);
+bool load_tuning(char const* path, Tuning& table);
+bool save_tuning(char const* path, Tuning const& table);
+Nodes classify(std::vector<double> const& xcoords, std::size_t num_of_points);
+Construction select_construction(std::size_t num_of_points, Nodes nodes, Precision precision);
+Multiplication select_multiplication(std::size_t p_size, std::size_t q_size);
+double cost_growth(std::size_t num_of_points, Construction construction);
+double& cost_coefficient(Tuning& table, Construction construction);
+double predict_cost(std::size_t num_of_points, Construction construction, std::size_t num_of_queries=0);
+double predict_cost(std::size_t num_of_points, Construction construction, Arithmetic arithmetic,
+                    std::size_t precision, std::size_t num_of_queries=0);
+
+#endif  // LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_TUNING_HH_
@@ -0,0 +1,76 @@
+#ifndef LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_WORKERS_HH_
+#define LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_WORKERS_HH_
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <sys/types.h>
+
+// Result of a task carried out by a worker process. `report` is anything else
+// the worker sent back (such as what it measured). If the task was given up
+// because the workers carrying it out died, `errors` says how the last one
+// died.
+struct Outcome
+{
+    std::size_t index;
+    int status;
+    std::string output, errors, report;
+    bool abandoned;
+};
+
+// Pool of worker processes forked from this one, each with its own address
+// space (and hence its own allocator). Tasks are sent to them through pipes
+// as strings, and their outcomes received the same way. A worker is given a
+// few tasks at a time, to keep it busy while its outcomes travel back. If a
+// worker dies, it is replaced and its unfinished tasks are sent to other
+// workers; a task which was being carried out by two workers which died is
+// given up.
+class Workers
+{
+    public:
+    using Handler = std::function<int(std::string const& task, std::string& output, std::string& errors,
+                                      std::string& report)>;
+
+    private:
+    struct Worker
+    {
+        pid_t pid = -1;
+        int to = -1, from = -1;
+        std::string outgoing, incoming;
+        std::size_t sent = 0;
+        std::deque<std::size_t> outstanding;
+    };
+    struct Task
+    {
+        std::string payload;
+        int attempts = 0;
+    };
+    Handler handler;
+    std::size_t depth;
+    std::vector<Worker> workers;
+    std::map<std::size_t, Task> tasks;
+    std::deque<std::size_t> queued;
+    std::size_t num_of_restarts;
+
+    void spawn(Worker& worker);
+    void serve(int in, int out);
+    void dispatch(void);
+    void replace(Worker& worker, std::vector<Outcome>& finished);
+    void receive(Worker& worker, std::vector<Outcome>& finished);
+
+    public:
+    Workers(std::size_t num_of_workers, Handler handler, std::size_t depth=4);
+    Workers(Workers const&) = delete;
+    Workers& operator=(Workers const&) = delete;
+    ~Workers();
+    void submit(std::size_t index, std::string&& task);
+    std::size_t backlog(void) const;
+    void collect(std::vector<Outcome>& finished);
+    std::size_t restarts(void) const;
+};
+
+#endif  // LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_WORKERS_HH_
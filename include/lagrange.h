@@ -0,0 +1,47 @@
+#ifndef LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_LAGRANGE_H_
+#define LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_LAGRANGE_H_
+
+/* C interface to the library. Functions may be added to it, but those below
+ * shall not change, so that programs linked against one version of the shared
+ * library continue to work with later ones. */
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LIP_ABI_VERSION 1
+
+/* Status codes returned by the functions below. */
+#define LIP_OK 0
+#define LIP_EINVAL 1
+#define LIP_ENOMEM 2
+#define LIP_ERANGE 3
+#define LIP_EFAIL 4
+#define LIP_ETIMEDOUT 5
+
+typedef struct lip_polynomial lip_polynomial;
+
+/* The functions taking a timeout give up after that many seconds, returning
+ * `LIP_ETIMEDOUT`. A timeout which is zero or negative (or too large to be
+ * represented) means that there is no timeout, as with `sequence --timeout 0`;
+ * one which is NaN is rejected with `LIP_EINVAL`. */
+
+int lip_abi_version(void);
+int lip_interpolate(double const* xcoords, double const* ycoords, size_t num_of_points,
+                    lip_polynomial** polynomial);
+int lip_interpolate_timeout(double const* xcoords, double const* ycoords, size_t num_of_points,
+                            double timeout, lip_polynomial** polynomial);
+int lip_coefficients(lip_polynomial const* polynomial, double* coefficients, size_t capacity,
+                     size_t* num_of_coefficients);
+int lip_eval_batch(lip_polynomial const* polynomial, double const* xcoords, double* ycoords, size_t count);
+int lip_eval_batch_timeout(lip_polynomial const* polynomial, double const* xcoords, double* ycoords, size_t count,
+                           double timeout);
+void lip_free(lip_polynomial* polynomial);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* LAGRANGE_INTERPOLATING_POLYNOMIAL_INCLUDE_LAGRANGE_H_ */
@@ -0,0 +1,170 @@
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+
+#include "Allocations.hh"
+
+// Each thread counts its own allocations, so that allocating does not contend
+// for a shared cache line; the counts are added up only when they are read.
+// Threads link their counters into a list the first time they allocate, and
+// move their counts to the totals of exited threads when they exit.
+struct Counter
+{
+    std::atomic<std::uint64_t> count, bytes;
+    bool linked, exited;
+    Counter* previous;
+    Counter* next;
+};
+struct Unlinker
+{
+    ~Unlinker();
+};
+static std::atomic<bool> counting(false);
+static std::mutex counters_mutex;
+static Counter* all_counters = nullptr;
+static std::uint64_t num_of_exited_allocations = 0, num_of_exited_allocated_bytes = 0;
+static thread_local Counter counter;
+
+/******************************************************************************
+ * Destructor. Move the counts of the exiting thread to the totals of exited
+ * threads.
+ *****************************************************************************/
+Unlinker::~Unlinker()
+{
+    std::lock_guard<std::mutex> lock(counters_mutex);
+    num_of_exited_allocations += counter.count.load(std::memory_order_relaxed);
+    num_of_exited_allocated_bytes += counter.bytes.load(std::memory_order_relaxed);
+    (counter.previous == nullptr ? all_counters : counter.previous->next) = counter.next;
+    if(counter.next != nullptr)
+    {
+        counter.next->previous = counter.previous;
+    }
+    counter.exited = true;
+}
+
+/******************************************************************************
+ * Start counting allocations. Those made earlier are not counted.
+ *****************************************************************************/
+void count_allocations(void)
+{
+    counting.store(true, std::memory_order_relaxed);
+}
+
+/******************************************************************************
+ * Add up the allocations counted.
+ *
+ * @param bytes Whether to add up their sizes instead of their number.
+ *
+ * @return Total.
+ *****************************************************************************/
+std::uint64_t total_allocations(bool bytes)
+{
+    std::lock_guard<std::mutex> lock(counters_mutex);
+    std::uint64_t total = bytes ? num_of_exited_allocated_bytes : num_of_exited_allocations;
+    for(Counter* other = all_counters; other != nullptr; other = other->next)
+    {
+        total += (bytes ? other->bytes : other->count).load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+/******************************************************************************
+ * Count an allocation, if allocations are being counted, and make it.
+ *
+ * @param size Number of bytes requested.
+ * @param alignment Alignment requested. Must be a power of 2.
+ *
+ * @return Pointer to the memory allocated, or `nullptr` if it could not be.
+ *****************************************************************************/
+static void* allocate(std::size_t size, std::size_t alignment)
+{
+    if(counting.load(std::memory_order_relaxed) && !counter.exited)
+    {
+        if(!counter.linked)
+        {
+            // Its destructor runs when this thread exits.
+            thread_local Unlinker unlinker;
+            std::lock_guard<std::mutex> lock(counters_mutex);
+            counter.next = all_counters;
+            if(all_counters != nullptr)
+            {
+                all_counters->previous = &counter;
+            }
+            all_counters = &counter;
+            counter.linked = true;
+        }
+        counter.count.store(counter.count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        counter.bytes.store(counter.bytes.load(std::memory_order_relaxed) + size, std::memory_order_relaxed);
+    }
+    if(alignment <= alignof(std::max_align_t))
+    {
+        return std::malloc(size == 0 ? 1 : size);
+    }
+
+    // The size must be a multiple of the alignment.
+    return std::aligned_alloc(alignment, (size / alignment + (size % alignment != 0 || size == 0)) * alignment);
+}
+
+// The forms for arrays call these, unless replaced.
+void* operator new(std::size_t size)
+{
+    void* pointer = allocate(size, alignof(std::max_align_t));
+    if(pointer == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    void* pointer = allocate(size, static_cast<std::size_t>(alignment));
+    if(pointer == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void* operator new(std::size_t size, std::nothrow_t const&) noexcept
+{
+    return allocate(size, alignof(std::max_align_t));
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, std::nothrow_t const&) noexcept
+{
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::nothrow_t const&) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t, std::nothrow_t const&) noexcept
+{
+    std::free(pointer);
+}
@@ -0,0 +1,256 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Barycentric.hh"
+#include "Cancellation.hh"
+#include "Tuning.hh"
+
+#define THROW(exception, message)  \
+{  \
+    throw exception(std::string(__FILE__) + ':' + std::to_string(__LINE__)  \
+                    + ", in function " + __func__ + ". " + message);  \
+}
+
+// Each thread computes the weights of a block of `row_tile` x-coordinates at
+// a time, multiplying in the differences from `column_tile` x-coordinates
+// before renormalising. Products of so few differences overflow or underflow
+// only if the x-coordinates are extremely large or extremely clustered, in
+// which case they are recomputed one factor at a time.
+constexpr std::size_t row_tile = 256;
+constexpr std::size_t column_tile = 8;
+
+/******************************************************************************
+ * Compute the reciprocals of the barycentric weights of some x-coordinates in
+ * scaled form: as mantissas (in [0.5, 1) in magnitude) and separate binary
+ * exponents, so that they neither overflow nor underflow.
+ *
+ * @param xcoords All x-coordinates.
+ * @param num_of_points Number of x-coordinates.
+ * @param begin Index of the first x-coordinate to compute the weight of.
+ * @param end Index past the last x-coordinate to compute the weight of.
+ * @param mantissas Array to write the mantissas to, at the same indices as
+ *     the x-coordinates.
+ * @param exponents Array to write the exponents to, at the same indices as the
+ *     x-coordinates.
+ * @param cancellation
+ *****************************************************************************/
+static void reciprocal_weights(double const* xcoords, std::size_t num_of_points, std::size_t begin,
+                               std::size_t end, double* mantissas, int long* exponents,
+                               Cancellation const* cancellation)
+{
+    double products[row_tile], saved[row_tile];
+    int long sums[row_tile];
+    for(std::size_t row = begin; row < end; row += row_tile)
+    {
+        check(cancellation);
+        std::size_t rows = std::min(row_tile, end - row);
+        double const* row_xcoords = xcoords + row;
+        std::fill(products, products + rows, 1.0);
+        std::fill(sums, sums + rows, 0);
+        for(std::size_t column = 0; column < num_of_points; column += column_tile)
+        {
+            std::size_t column_end = std::min(column + column_tile, num_of_points);
+            std::copy(products, products + rows, saved);
+
+            // The difference of an x-coordinate from itself is the only one
+            // which is zero; it is skipped by multiplying by 1 instead. This
+            // is written without a branch so that the loop is vectorised.
+            for(std::size_t k = column; k < column_end; ++k)
+            {
+                double xcoord = xcoords[k];
+                #pragma omp simd
+                for(std::size_t i = 0; i < rows; ++i)
+                {
+                    double difference = row_xcoords[i] - xcoord;
+                    products[i] *= difference + (difference == 0);
+                }
+            }
+
+            for(std::size_t i = 0; i < rows; ++i)
+            {
+                int exponent;
+                if(std::isnormal(products[i]))
+                {
+                    products[i] = std::frexp(products[i], &exponent);
+                    sums[i] += exponent;
+                    continue;
+                }
+                products[i] = saved[i];
+                for(std::size_t k = column; k < column_end; ++k)
+                {
+                    double difference = row_xcoords[i] - xcoords[k];
+                    products[i] = std::frexp(products[i] * (difference + (difference == 0)), &exponent);
+                    sums[i] += exponent;
+                }
+            }
+        }
+        std::copy(products, products + rows, mantissas + row);
+        std::copy(sums, sums + rows, exponents + row);
+    }
+}
+
+/******************************************************************************
+ * Compute the barycentric weights of some x-coordinates. The weight of the
+ * jth x-coordinate is the reciprocal of the product of its differences from
+ * all the others. The weights are returned scaled by a common factor (which
+ * does not affect barycentric interpolation), such that the largest of them is
+ * close to 1 in magnitude.
+ *
+ * @param xcoords x-coordinates. They must be distinct.
+ * @param num_of_threads Number of threads to split the x-coordinates among. If
+ *     0, all hardware threads are used for many points, and one thread for a
+ *     few; see `Tuning::parallel_weights_min_points`.
+ * @param cancellation Token polled periodically, or `nullptr`. If it expires,
+ *     `Expired` is thrown.
+ *
+ * @return Barycentric weights.
+ *****************************************************************************/
+std::vector<double> barycentric_weights(std::vector<double> const& xcoords, std::size_t num_of_threads,
+                                        Cancellation const* cancellation)
+{
+    std::size_t num_of_points = xcoords.size();
+    if(num_of_points <= 1)
+    {
+        return std::vector<double>(num_of_points, 1.0);
+    }
+
+    if(num_of_threads == 0)
+    {
+        num_of_threads = 1;
+        if(num_of_points >= tuning().parallel_weights_min_points)
+        {
+            num_of_threads = std::max(std::thread::hardware_concurrency(), 1U);
+        }
+    }
+    std::size_t num_of_tiles = (num_of_points + row_tile - 1) / row_tile;
+    num_of_threads = std::min(num_of_threads, num_of_tiles);
+
+    // Give each thread a contiguous range of whole tiles.
+    std::vector<double> mantissas(num_of_points);
+    std::vector<int long> exponents(num_of_points);
+    std::vector<std::exception_ptr> errors(num_of_threads);
+    auto work = [&](std::size_t thread)
+    {
+        std::size_t begin = std::min(num_of_tiles * thread / num_of_threads * row_tile, num_of_points);
+        std::size_t end = std::min(num_of_tiles * (thread + 1) / num_of_threads * row_tile, num_of_points);
+        try
+        {
+            reciprocal_weights(xcoords.data(), num_of_points, begin, end, mantissas.data(), exponents.data(),
+                               cancellation);
+        }
+        catch(...)
+        {
+            errors[thread] = std::current_exception();
+        }
+    };
+    std::vector<std::thread> threads;
+    for(std::size_t thread = 1; thread < num_of_threads; ++thread)
+    {
+        threads.emplace_back(work, thread);
+    }
+    work(0);
+    for(auto& thread: threads)
+    {
+        thread.join();
+    }
+    for(auto const& error: errors)
+    {
+        if(error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+    // The reciprocal of a mantissa lies in (1, 2] in magnitude. Scale all
+    // weights such that the largest binary exponent becomes 0.
+    int long largest = -*std::min_element(exponents.begin(), exponents.end());
+    std::vector<double> weights(num_of_points);
+    for(std::size_t i = 0; i < num_of_points; ++i)
+    {
+        int long exponent = -exponents[i] - largest;
+        weights[i] = std::ldexp(1 / mantissas[i], static_cast<int>(std::max<int long>(exponent, -2000)));
+    }
+    return weights;
+}
+
+/******************************************************************************
+ * Constructor. Given the x- and y-coordinates of a set of points, find the
+ * barycentric form of the polynomial which passes through all of them. If the
+ * two arguments are of different sizes, the extra coordinates present at the
+ * end of the larger argument are ignored.
+ *
+ * @param xcoords
+ * @param ycoords
+ * @param cancellation Token polled periodically, or `nullptr`. If it expires,
+ *     `Expired` is thrown.
+ *
+ * @return A polynomial passing through the given points.
+ *****************************************************************************/
+Barycentric::Barycentric(std::vector<double> const& xcoords, std::vector<double> const& ycoords,
+                         Cancellation const* cancellation)
+{
+    std::size_t num_of_points = std::min(xcoords.size(), ycoords.size());
+    if(num_of_points <= 1)
+    {
+        THROW(std::invalid_argument, "At least two points are required for interpolation.")
+    }
+    this->xcoords.assign(xcoords.begin(), xcoords.begin() + num_of_points);
+    this->ycoords.assign(ycoords.begin(), ycoords.begin() + num_of_points);
+    std::vector<double> sorted = this->xcoords;
+    std::sort(sorted.begin(), sorted.end());
+    auto duplicate = std::adjacent_find(sorted.begin(), sorted.end());
+    if(duplicate != sorted.end())
+    {
+        auto str_xcoord = std::to_string(*duplicate);
+        std::string message = "Expected distinct x-coordinates, but " + str_xcoord + " occurs multiple times.";
+        THROW(std::invalid_argument, message)
+    }
+    this->weights = barycentric_weights(this->xcoords, 0, cancellation);
+}
+
+/******************************************************************************
+ * Evaluate the polynomial using the second (true) barycentric formula.
+ *
+ * @param x x-coordinate of the point to evaluate the polynomial at.
+ *
+ * @return y-coordinate of the polynomial at the given x-coordinate.
+ *****************************************************************************/
+double Barycentric::operator()(double x) const
+{
+    double numerator = 0;
+    double denominator = 0;
+    for(std::size_t j = 0; j < this->xcoords.size(); ++j)
+    {
+        double difference = x - this->xcoords[j];
+        if(difference == 0)
+        {
+            return this->ycoords[j];
+        }
+        double term = this->weights[j] / difference;
+        numerator += term * this->ycoords[j];
+        denominator += term;
+    }
+    return numerator / denominator;
+}
+
+/******************************************************************************
+ * Evaluate the polynomial at several points.
+ *
+ * @param xcoords x-coordinates of the points to evaluate the polynomial at.
+ * @param ycoords Array to write the y-coordinates of the polynomial at the
+ *     given x-coordinates to. It may be the same as `xcoords`.
+ * @param count Number of points.
+ *****************************************************************************/
+void Barycentric::evaluate(double const* xcoords, double* ycoords, std::size_t count) const
+{
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        ycoords[i] = (*this)(xcoords[i]);
+    }
+}
@@ -0,0 +1,362 @@
+#include <algorithm>
+#include <cstddef>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+#include "Batch.hh"
+
+#define THROW(exception, message)  \
+{  \
+    throw exception(std::string(__FILE__) + ':' + std::to_string(__LINE__)  \
+                    + ", in function " + __func__ + ". " + message);  \
+}
+
+// Sets are processed this many at a time, one per lane. Their coordinates are
+// copied into arrays on the stack, in which the unused slots of the smaller
+// sets are padded such that the same arithmetic can be done on every lane
+// without branching.
+constexpr std::size_t lanes = 8;
+
+/******************************************************************************
+ * A block of sets, with the coordinates of the ith point of all sets in the
+ * ith row. The sizes are also kept as `double`s, so that loops over the lanes
+ * comparing them with row numbers can be vectorised along with the arithmetic.
+ *****************************************************************************/
+struct Block
+{
+    std::size_t count;
+    std::size_t sizes[lanes];
+    double rows[lanes];
+    double xcoords[batch_max_points][lanes];
+    double values[batch_max_points][lanes];
+};
+
+/******************************************************************************
+ * Check that the arguments describe a valid batch.
+ *
+ * @param num_of_sets
+ * @param sizes
+ * @param max_points
+ *****************************************************************************/
+static void validate(std::size_t num_of_sets, std::size_t const* sizes, std::size_t max_points)
+{
+    if(max_points == 0 || max_points > batch_max_points)
+    {
+        std::string message = "Expected between 1 and " + std::to_string(batch_max_points)
+                              + " points per set, but got " + std::to_string(max_points) + ".";
+        THROW(std::invalid_argument, message)
+    }
+    if(sizes == nullptr)
+    {
+        return;
+    }
+    for(std::size_t s = 0; s < num_of_sets; ++s)
+    {
+        if(sizes[s] == 0 || sizes[s] > max_points)
+        {
+            std::string message = "Set " + std::to_string(s) + " has " + std::to_string(sizes[s])
+                                  + " points, but at most " + std::to_string(max_points) + " are allowed.";
+            THROW(std::invalid_argument, message)
+        }
+    }
+}
+
+/******************************************************************************
+ * Copy a block of sets into stack arrays. Lanes past the last set are given a
+ * single point. Unused x-coordinates and values are set to 0, so that they
+ * contribute nothing to Horner's method.
+ *
+ * @param block Block to fill.
+ * @param first Index of the first set in the block.
+ * @param num_of_sets
+ * @param sizes
+ * @param max_points
+ * @param xcoords
+ * @param values y-coordinates or coefficients.
+ *****************************************************************************/
+static void load(Block& block, std::size_t first, std::size_t num_of_sets, std::size_t const* sizes,
+                 std::size_t max_points, double const* xcoords, double const* values)
+{
+    block.count = std::min(lanes, num_of_sets - first);
+    for(std::size_t l = 0; l < lanes; ++l)
+    {
+        block.sizes[l] = l < block.count ? (sizes == nullptr ? max_points : sizes[first + l]) : 1;
+        block.rows[l] = block.sizes[l];
+    }
+    for(std::size_t i = 0; i < max_points; ++i)
+    {
+        double const* xrow = xcoords + i * num_of_sets + first;
+        double const* vrow = values + i * num_of_sets + first;
+        for(std::size_t l = 0; l < lanes; ++l)
+        {
+            bool used = l < block.count && i < block.sizes[l];
+            block.xcoords[i][l] = used ? xrow[l] : 0;
+            block.values[i][l] = used ? vrow[l] : 0;
+        }
+    }
+}
+
+/******************************************************************************
+ * Copy the values of a block of sets out of stack arrays, zeroing the unused
+ * slots.
+ *
+ * @param block
+ * @param first Index of the first set in the block.
+ * @param num_of_sets
+ * @param max_points
+ * @param values Array to write to.
+ *****************************************************************************/
+static void store(Block const& block, std::size_t first, std::size_t num_of_sets, std::size_t max_points,
+                  double* values)
+{
+    for(std::size_t i = 0; i < max_points; ++i)
+    {
+        double* row = values + i * num_of_sets + first;
+        for(std::size_t l = 0; l < block.count; ++l)
+        {
+            row[l] = i < block.sizes[l] ? block.values[i][l] : 0;
+        }
+    }
+}
+
+/******************************************************************************
+ * Report the first set of a block whose x-coordinates are not distinct.
+ *
+ * @param block
+ * @param first Index of the first set in the block.
+ *****************************************************************************/
+static void reject(Block const& block, std::size_t first)
+{
+    for(std::size_t l = 0; l < block.count; ++l)
+    {
+        for(std::size_t i = 1; i < block.sizes[l]; ++i)
+        {
+            for(std::size_t j = 0; j < i; ++j)
+            {
+                if(block.xcoords[i][l] == block.xcoords[j][l])
+                {
+                    std::string message = "Expected distinct x-coordinates, but " + std::to_string(block.xcoords[i][l])
+                                          + " occurs multiple times in set " + std::to_string(first + l) + ".";
+                    THROW(std::invalid_argument, message)
+                }
+            }
+        }
+    }
+}
+
+/******************************************************************************
+ * Replace the y-coordinates of a block of sets with their divided differences
+ * (the coefficients of the Newton form). The recurrence is run over all
+ * `max_points` rows on every lane; the rows of a smaller set past its size may
+ * end up with meaningless values (including infinities), but are never read by
+ * the rows before them. Zero spacings in the rows which are used are counted on
+ * each lane as the spacings are divided by, and the counts added up at the
+ * end, so that duplicate x-coordinates are found without a separate pass.
+ *
+ * @param block
+ * @param max_points
+ *
+ * @return Number of zero spacings found, which is 0 if and only if the
+ *     x-coordinates of every set are distinct.
+ *****************************************************************************/
+static double divided_differences(Block& block, std::size_t max_points)
+{
+    double zeros[lanes] = {};
+    for(std::size_t k = 1; k < max_points; ++k)
+    {
+        for(std::size_t i = max_points - 1; i >= k; --i)
+        {
+            double row = i;
+            #pragma omp simd
+            for(std::size_t l = 0; l < lanes; ++l)
+            {
+                double spacing = block.xcoords[i][l] - block.xcoords[i - k][l];
+                zeros[l] += row < block.rows[l] ? static_cast<double>(spacing == 0) : 0.0;
+                block.values[i][l] = (block.values[i][l] - block.values[i - 1][l]) / spacing;
+            }
+        }
+    }
+    for(std::size_t i = 0; i < max_points; ++i)
+    {
+        for(std::size_t l = 0; l < lanes; ++l)
+        {
+            block.values[i][l] = i < block.sizes[l] ? block.values[i][l] : 0;
+        }
+    }
+    return std::accumulate(zeros, zeros + lanes, 0.0);
+}
+
+/******************************************************************************
+ * Find the coefficients of the Newton forms of the polynomials passing through
+ * each of several small sets of points.
+ *
+ * @param num_of_sets
+ * @param sizes Number of points in each set, or `nullptr`.
+ * @param max_points Number of rows in each array. At most `batch_max_points`.
+ * @param xcoords x-coordinates. They must be distinct within each set.
+ * @param ycoords y-coordinates.
+ * @param coefficients Array to write the coefficients to. The polynomial
+ *     through the sth set is the sum over i of the ith coefficient times the
+ *     product of (x minus the jth x-coordinate) for all j less than i. It may
+ *     be the same as `ycoords`.
+ *****************************************************************************/
+void batch_newton(std::size_t num_of_sets, std::size_t const* sizes, std::size_t max_points,
+                  double const* xcoords, double const* ycoords, double* coefficients)
+{
+    validate(num_of_sets, sizes, max_points);
+    Block block;
+    for(std::size_t first = 0; first < num_of_sets; first += lanes)
+    {
+        load(block, first, num_of_sets, sizes, max_points, xcoords, ycoords);
+        if(divided_differences(block, max_points) > 0)
+        {
+            reject(block, first);
+        }
+        store(block, first, num_of_sets, max_points, coefficients);
+    }
+}
+
+/******************************************************************************
+ * Find the coefficients of the polynomials passing through each of several
+ * small sets of points, in increasing order of the exponent of the variable.
+ *
+ * @param num_of_sets
+ * @param sizes Number of points in each set, or `nullptr`.
+ * @param max_points Number of rows in each array. At most `batch_max_points`.
+ * @param xcoords x-coordinates. They must be distinct within each set.
+ * @param ycoords y-coordinates.
+ * @param coefficients Array to write the coefficients to. It may be the same
+ *     as `ycoords`.
+ *****************************************************************************/
+void batch_monomial(std::size_t num_of_sets, std::size_t const* sizes, std::size_t max_points,
+                    double const* xcoords, double const* ycoords, double* coefficients)
+{
+    validate(num_of_sets, sizes, max_points);
+    Block block;
+    for(std::size_t first = 0; first < num_of_sets; first += lanes)
+    {
+        load(block, first, num_of_sets, sizes, max_points, xcoords, ycoords);
+        if(divided_differences(block, max_points) > 0)
+        {
+            reject(block, first);
+        }
+
+        // Expand the Newton form one node at a time, from the innermost. The
+        // unused coefficients are zero, so the extra steps on the lanes of
+        // smaller sets change nothing.
+        for(std::size_t k = max_points - 1; k >= 1; --k)
+        {
+            for(std::size_t i = k - 1; i + 1 < max_points; ++i)
+            {
+                #pragma omp simd
+                for(std::size_t l = 0; l < lanes; ++l)
+                {
+                    block.values[i][l] -= block.xcoords[k - 1][l] * block.values[i + 1][l];
+                }
+            }
+        }
+        store(block, first, num_of_sets, max_points, coefficients);
+    }
+}
+
+/******************************************************************************
+ * Evaluate the Newton forms found by `batch_newton`, each at one point.
+ *
+ * @param num_of_sets
+ * @param sizes Number of points in each set, or `nullptr`.
+ * @param max_points Number of rows in each array. At most `batch_max_points`.
+ * @param xcoords x-coordinates the polynomials were found from.
+ * @param coefficients Coefficients of the Newton forms.
+ * @param queries x-coordinate to evaluate each polynomial at.
+ * @param results Array to write the y-coordinates to. It may be the same as
+ *     `queries`.
+ *****************************************************************************/
+void batch_evaluate(std::size_t num_of_sets, std::size_t const* sizes, std::size_t max_points,
+                    double const* xcoords, double const* coefficients, double const* queries, double* results)
+{
+    validate(num_of_sets, sizes, max_points);
+    Block block;
+    for(std::size_t first = 0; first < num_of_sets; first += lanes)
+    {
+        load(block, first, num_of_sets, sizes, max_points, xcoords, coefficients);
+        double x[lanes], y[lanes] = {};
+        for(std::size_t l = 0; l < lanes; ++l)
+        {
+            x[l] = l < block.count ? queries[first + l] : 0;
+        }
+
+        // Horner's method. On the lanes of smaller sets, the result stays zero
+        // until their last coefficient is reached.
+        for(std::size_t i = max_points; i-- > 0;)
+        {
+            #pragma omp simd
+            for(std::size_t l = 0; l < lanes; ++l)
+            {
+                y[l] = y[l] * (x[l] - block.xcoords[i][l]) + block.values[i][l];
+            }
+        }
+        std::copy(y, y + block.count, results + first);
+    }
+}
+
+/******************************************************************************
+ * Evaluate the polynomials passing through each of several small sets of
+ * points, each at one point, using Neville's algorithm. No coefficients are
+ * found, which makes this more accurate than `batch_newton` followed by
+ * `batch_evaluate` when each polynomial is needed only once.
+ *
+ * @param num_of_sets
+ * @param sizes Number of points in each set, or `nullptr`.
+ * @param max_points Number of rows in each array. At most `batch_max_points`.
+ * @param xcoords x-coordinates. They must be distinct within each set.
+ * @param ycoords y-coordinates.
+ * @param queries x-coordinate to evaluate each polynomial at.
+ * @param results Array to write the y-coordinates to. It may be the same as
+ *     `queries`.
+ *****************************************************************************/
+void batch_neville(std::size_t num_of_sets, std::size_t const* sizes, std::size_t max_points,
+                   double const* xcoords, double const* ycoords, double const* queries, double* results)
+{
+    validate(num_of_sets, sizes, max_points);
+    Block block;
+    for(std::size_t first = 0; first < num_of_sets; first += lanes)
+    {
+        load(block, first, num_of_sets, sizes, max_points, xcoords, ycoords);
+        double x[lanes];
+        for(std::size_t l = 0; l < lanes; ++l)
+        {
+            x[l] = l < block.count ? queries[first + l] : 0;
+        }
+
+        // After the kth step, the ith row holds the value of the polynomial
+        // through the points from i - k to i. Like the divided differences,
+        // rows past the size of a set are meaningless but never read, and
+        // zero spacings in the other rows are counted.
+        double zeros[lanes] = {};
+        for(std::size_t k = 1; k < max_points; ++k)
+        {
+            for(std::size_t i = max_points - 1; i >= k; --i)
+            {
+                double row = i;
+                #pragma omp simd
+                for(std::size_t l = 0; l < lanes; ++l)
+                {
+                    double lower = x[l] - block.xcoords[i - k][l];
+                    double upper = x[l] - block.xcoords[i][l];
+                    double spacing = block.xcoords[i][l] - block.xcoords[i - k][l];
+                    zeros[l] += row < block.rows[l] ? static_cast<double>(spacing == 0) : 0.0;
+                    block.values[i][l] = (lower * block.values[i][l] - upper * block.values[i - 1][l]) / spacing;
+                }
+            }
+        }
+        if(std::accumulate(zeros, zeros + lanes, 0.0) > 0)
+        {
+            reject(block, first);
+        }
+        for(std::size_t l = 0; l < block.count; ++l)
+        {
+            results[first + l] = block.values[block.sizes[l] - 1][l];
+        }
+    }
+}
@@ -0,0 +1,447 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "BigFloat.hh"
+#include "Rational.hh"
+
+#define THROW(exception, message)  \
+{  \
+    throw exception(std::string(__FILE__) + ':' + std::to_string(__LINE__)  \
+                    + ", in function " + __func__ + ". " + message);  \
+}
+
+/******************************************************************************
+ * Raise an integer to a power using repeated squaring.
+ *
+ * @param base
+ * @param power
+ *
+ * @return `base` to the power `power`.
+ *****************************************************************************/
+static BigInteger raise(BigInteger base, std::size_t power)
+{
+    BigInteger result = 1;
+    for(; power > 0; power >>= 1)
+    {
+        if(power & 1)
+        {
+            result = result * base;
+        }
+        if(power > 1)
+        {
+            base = base * base;
+        }
+    }
+    return result;
+}
+
+/******************************************************************************
+ * Round the mantissa to the precision, to nearest with ties to even, and
+ * remove its trailing zero bits. A precision of zero means that the number is
+ * exact, and it is not rounded.
+ *
+ * @param inexact Whether the exact number is slightly larger in magnitude
+ *     than this number: by less than a unit in the last place of the mantissa
+ *     when it has more bits than the precision.
+ *****************************************************************************/
+void BigFloat::round(bool inexact)
+{
+    std::size_t length = this->mantissa.bit_length();
+    if(this->precision > 0 && length > this->precision)
+    {
+        std::size_t shift = length - this->precision;
+        BigInteger magnitude = this->mantissa.abs();
+        BigInteger quotient = magnitude >> shift;
+        int comparison = compare(magnitude - (quotient << shift), BigInteger(1) << (shift - 1));
+        if(comparison > 0 || (comparison == 0 && (inexact || quotient.trailing_zeros() == 0)))
+        {
+            quotient = quotient + 1;
+        }
+        this->mantissa = this->mantissa.sign() < 0 ? -quotient : quotient;
+        this->exponent += shift;
+    }
+    if(this->mantissa.is_zero())
+    {
+        this->exponent = 0;
+        return;
+    }
+    std::size_t zeros = this->mantissa.trailing_zeros();
+    this->mantissa = this->mantissa >> zeros;
+    this->exponent += zeros;
+}
+
+/******************************************************************************
+ * Divide two integers, and multiply the quotient by a power of 2. The
+ * quotient is found to two more bits than the precision, and whether the
+ * remainder is zero decides how ties are rounded.
+ *
+ * @param numerator
+ * @param denominator Must not be zero.
+ * @param exponent
+ * @param precision If zero (the quotient of two integers), 64 bits are used.
+ *
+ * @return Correctly rounded result.
+ *****************************************************************************/
+BigFloat BigFloat::divide(BigInteger const& numerator, BigInteger const& denominator, long long exponent,
+                          std::size_t precision)
+{
+    if(denominator.is_zero())
+    {
+        THROW(std::domain_error, "Division by zero.")
+    }
+    if(precision == 0)
+    {
+        precision = std::numeric_limits<unsigned long long>::digits;
+    }
+    BigFloat result;
+    result.precision = precision;
+    if(numerator.is_zero())
+    {
+        return result;
+    }
+    long long shift = static_cast<long long>(precision + 2 + denominator.bit_length())
+                      - static_cast<long long>(numerator.bit_length());
+    shift = std::max(shift, 0LL);
+    BigInteger remainder;
+    ::divide(numerator << shift, denominator, result.mantissa, remainder);
+    result.exponent = exponent - shift;
+    result.round(!remainder.is_zero());
+    return result;
+}
+
+/******************************************************************************
+ * Constructors. Integers are exact, and have no precision of their own (their
+ * precision is zero), so that an operation on an integer and another number
+ * has the precision of the other number. Otherwise, a constant such as the 0
+ * which Horner's method starts from would raise the precision of every result
+ * to 64 bits.
+ *
+ * @param value
+ *****************************************************************************/
+BigFloat::BigFloat(int value)
+: BigFloat(static_cast<long long>(value))
+{
+}
+
+BigFloat::BigFloat(long long value)
+: mantissa(value), exponent(0), precision(0)
+{
+    this->round();
+}
+
+/******************************************************************************
+ * Constructor.
+ *
+ * @param value Must be finite.
+ * @param precision Number of bits. Must be positive. If it is less than 53,
+ *     `value` is rounded.
+ *****************************************************************************/
+BigFloat::BigFloat(double value, std::size_t precision)
+: exponent(0), precision(precision)
+{
+    if(!std::isfinite(value))
+    {
+        THROW(std::invalid_argument, "Expected a finite number, but got " + std::to_string(value) + ".")
+    }
+    if(precision == 0)
+    {
+        THROW(std::invalid_argument, "Expected a positive precision.")
+    }
+    int exponent;
+    double fraction = std::frexp(value, &exponent);
+    this->mantissa = static_cast<long long>(std::ldexp(fraction, std::numeric_limits<double>::digits));
+    this->exponent = exponent - std::numeric_limits<double>::digits;
+    this->round();
+}
+
+/******************************************************************************
+ * Constructor.
+ *
+ * @param value
+ * @param precision Number of bits. Must be positive.
+ *****************************************************************************/
+BigFloat::BigFloat(Rational const& value, std::size_t precision)
+{
+    if(precision == 0)
+    {
+        THROW(std::invalid_argument, "Expected a positive precision.")
+    }
+    *this = divide(value.get_numerator(), value.get_denominator(), 0, precision);
+}
+
+/******************************************************************************
+ * @return Number of bits in the mantissa, or zero if this number is exact.
+ *****************************************************************************/
+std::size_t BigFloat::get_precision(void) const
+{
+    return this->precision;
+}
+
+/******************************************************************************
+ * @return -1, 0 or 1 as this number is negative, zero or positive.
+ *****************************************************************************/
+int BigFloat::sign(void) const
+{
+    return this->mantissa.sign();
+}
+
+/******************************************************************************
+ * @return Floating-point number nearest to this number.
+ *****************************************************************************/
+double BigFloat::to_double(void) const
+{
+    // Near the smallest normal number, rounding to 53 bits and then to fewer
+    // would not be correct.
+    long long top = this->exponent + static_cast<long long>(this->mantissa.bit_length());
+    if(top <= std::numeric_limits<double>::min_exponent)
+    {
+        return this->to_rational().to_double();
+    }
+    BigFloat rounded = *this;
+    rounded.precision = std::numeric_limits<double>::digits;
+    rounded.round();
+    if(top > std::numeric_limits<double>::max_exponent)
+    {
+        return rounded.sign() * std::numeric_limits<double>::infinity();
+    }
+    return std::ldexp(rounded.mantissa.to_double(), static_cast<int>(rounded.exponent));
+}
+
+/******************************************************************************
+ * @return This number, exactly.
+ *****************************************************************************/
+Rational BigFloat::to_rational(void) const
+{
+    if(this->exponent >= 0)
+    {
+        return Rational(this->mantissa << this->exponent);
+    }
+    return Rational(this->mantissa, BigInteger(1) << -this->exponent);
+}
+
+/******************************************************************************
+ * @return Decimal representation of this number, with enough significant
+ *     digits to tell it apart from every other number of its precision, but
+ *     no trailing zeros. As with `%g`, in scientific notation if the decimal
+ *     exponent is less than -5 or not less than the number of digits.
+ *****************************************************************************/
+std::string BigFloat::to_string(void) const
+{
+    if(this->mantissa.is_zero())
+    {
+        return "0";
+    }
+
+    // Find the digits as an integer, and the decimal exponent of the first,
+    // starting from an estimate which may be off by one.
+    std::size_t precision = this->precision > 0 ? this->precision : this->mantissa.bit_length();
+    long long num_of_digits = 1 + static_cast<long long>(std::ceil(precision * std::log10(2.0)));
+    long long top = this->exponent + static_cast<long long>(this->mantissa.bit_length());
+    auto decimal_exponent = static_cast<long long>(std::floor((top - 1) * std::log10(2.0)));
+    BigInteger lowest = raise(10, num_of_digits - 1), highest = lowest * 10, digits;
+    for(;;)
+    {
+        long long scale = num_of_digits - 1 - decimal_exponent;
+        BigInteger numerator = this->mantissa.abs(), denominator = 1;
+        numerator = scale >= 0 ? numerator * raise(10, scale) : numerator;
+        denominator = scale < 0 ? denominator * raise(10, -scale) : denominator;
+        numerator = this->exponent >= 0 ? numerator << this->exponent : numerator;
+        denominator = this->exponent < 0 ? denominator << -this->exponent : denominator;
+        BigInteger remainder;
+        ::divide(numerator, denominator, digits, remainder);
+        int comparison = compare(remainder << 1, denominator);
+        if(comparison > 0 || (comparison == 0 && digits.trailing_zeros() == 0))
+        {
+            digits = digits + 1;
+        }
+        if(!(digits < highest))
+        {
+            ++decimal_exponent;
+        }
+        else if(digits < lowest)
+        {
+            --decimal_exponent;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    std::string text = digits.to_string();
+    text.erase(text.find_last_not_of('0') + 1);
+    std::string result = this->mantissa.sign() < 0 ? "-" : "";
+    if(decimal_exponent < -5 || decimal_exponent >= num_of_digits)
+    {
+        result += text.substr(0, 1);
+        if(text.size() > 1)
+        {
+            result += '.' + text.substr(1);
+        }
+        std::string magnitude = std::to_string(std::abs(decimal_exponent));
+        return result + (decimal_exponent < 0 ? "e-" : "e+") + (magnitude.size() < 2 ? "0" : "") + magnitude;
+    }
+    if(decimal_exponent < 0)
+    {
+        return result + "0." + std::string(-decimal_exponent - 1, '0') + text;
+    }
+    auto integer_digits = static_cast<std::size_t>(decimal_exponent + 1);
+    if(text.size() <= integer_digits)
+    {
+        return result + text + std::string(integer_digits - text.size(), '0');
+    }
+    return result + text.substr(0, integer_digits) + '.' + text.substr(integer_digits);
+}
+
+/******************************************************************************
+ * Add two numbers. If one is smaller than half a unit in the last place of the
+ * other, the sum rounds to the larger one, which is returned without adding
+ * (so that the smaller one need not be shifted by a large number of bits).
+ * The sum of two exact numbers is exact.
+ *
+ * @param a
+ * @param b
+ *
+ * @return Sum.
+ *****************************************************************************/
+BigFloat operator+(BigFloat const& a, BigFloat const& b)
+{
+    std::size_t precision = std::max(a.precision, b.precision);
+    long long a_top = a.exponent + static_cast<long long>(a.mantissa.bit_length());
+    long long b_top = b.exponent + static_cast<long long>(b.mantissa.bit_length());
+    BigFloat result;
+    result.precision = precision;
+    bool exact = precision == 0;
+    if(b.mantissa.is_zero()
+       || (!exact && !a.mantissa.is_zero() && b_top + static_cast<long long>(precision) + 2 < a_top))
+    {
+        result.mantissa = a.mantissa;
+        result.exponent = a.exponent;
+    }
+    else if(a.mantissa.is_zero() || (!exact && a_top + static_cast<long long>(precision) + 2 < b_top))
+    {
+        result.mantissa = b.mantissa;
+        result.exponent = b.exponent;
+    }
+    else
+    {
+        result.exponent = std::min(a.exponent, b.exponent);
+        result.mantissa = (a.mantissa << (a.exponent - result.exponent))
+                          + (b.mantissa << (b.exponent - result.exponent));
+    }
+    result.round();
+    return result;
+}
+
+/******************************************************************************
+ * Multiply two numbers. The product of the mantissas is exact; it is found
+ * using Karatsuba's algorithm if they are long enough. The product of two
+ * exact numbers is exact.
+ *
+ * @param a
+ * @param b
+ *
+ * @return Product.
+ *****************************************************************************/
+BigFloat operator*(BigFloat const& a, BigFloat const& b)
+{
+    BigFloat result;
+    result.precision = std::max(a.precision, b.precision);
+    result.mantissa = a.mantissa * b.mantissa;
+    result.exponent = a.exponent + b.exponent;
+    result.round();
+    return result;
+}
+
+/******************************************************************************
+ * Divide two numbers.
+ *
+ * @param a
+ * @param b Must not be zero.
+ *
+ * @return Quotient.
+ *****************************************************************************/
+BigFloat operator/(BigFloat const& a, BigFloat const& b)
+{
+    return BigFloat::divide(a.mantissa, b.mantissa, a.exponent - b.exponent, std::max(a.precision, b.precision));
+}
+
+/******************************************************************************
+ * @param a
+ *
+ * @return Negation.
+ *****************************************************************************/
+BigFloat operator-(BigFloat const& a)
+{
+    BigFloat result = a;
+    result.mantissa = -result.mantissa;
+    return result;
+}
+
+/******************************************************************************
+ * Compare two numbers. Each number has one representation, whatever its
+ * precision.
+ *
+ * @param a
+ * @param b
+ *
+ * @return `true` if they are equal, else `false`.
+ *****************************************************************************/
+bool operator==(BigFloat const& a, BigFloat const& b)
+{
+    return a.mantissa == b.mantissa && a.exponent == b.exponent;
+}
+
+BigFloat operator-(BigFloat const& a, BigFloat const& b)
+{
+    return a + -b;
+}
+
+void operator+=(BigFloat& a, BigFloat const& b)
+{
+    a = a + b;
+}
+
+void operator-=(BigFloat& a, BigFloat const& b)
+{
+    a = a - b;
+}
+
+void operator*=(BigFloat& a, BigFloat const& b)
+{
+    a = a * b;
+}
+
+void operator/=(BigFloat& a, BigFloat const& b)
+{
+    a = a / b;
+}
+
+bool operator!=(BigFloat const& a, BigFloat const& b)
+{
+    return !(a == b);
+}
+
+/******************************************************************************
+ * Compare two numbers. A correctly rounded difference has the sign of the
+ * exact one.
+ *
+ * @param a
+ * @param b
+ *
+ * @return `true` if `a` is less than `b`, else `false`.
+ *****************************************************************************/
+bool operator<(BigFloat const& a, BigFloat const& b)
+{
+    return (a - b).sign() < 0;
+}
+
+std::ostream& operator<<(std::ostream& ostream, BigFloat const& a)
+{
+    return ostream << a.to_string();
+}
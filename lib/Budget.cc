@@ -0,0 +1,186 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+
+#include "Budget.hh"
+#include "Tuning.hh"
+
+/******************************************************************************
+ * Constructor.
+ *
+ * @param limit Number of bytes available. If 0, there is no limit.
+ *****************************************************************************/
+Budget::Budget(std::size_t limit)
+: limit(limit == 0 ? std::numeric_limits<std::size_t>::max() : limit), in_use(0), peak(0), num_of_waits(0),
+  num_of_rejections(0)
+{
+}
+
+/******************************************************************************
+ * Reserve memory for a computation, waiting until enough is available.
+ *
+ * @param bytes Estimated peak footprint of the computation.
+ *
+ * @return `true` if the memory was reserved, `false` if the computation needs
+ *     more than the whole budget.
+ *****************************************************************************/
+bool Budget::acquire(std::size_t bytes)
+{
+    std::unique_lock<std::mutex> lock(this->mutex);
+    if(bytes > this->limit)
+    {
+        ++this->num_of_rejections;
+        return false;
+    }
+    if(bytes > this->limit - this->in_use)
+    {
+        ++this->num_of_waits;
+        this->released.wait(lock, [&]{ return bytes <= this->limit - this->in_use; });
+    }
+    this->in_use += bytes;
+    this->peak = std::max(this->peak, this->in_use);
+    return true;
+}
+
+/******************************************************************************
+ * Return memory reserved for a computation which has finished.
+ *
+ * @param bytes Number of bytes reserved.
+ *****************************************************************************/
+void Budget::release(std::size_t bytes)
+{
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->in_use -= bytes;
+    }
+    this->released.notify_all();
+}
+
+/******************************************************************************
+ * @return Number of bytes available in all. The largest value of `size_t` if
+ *     there is no limit.
+ *****************************************************************************/
+std::size_t Budget::capacity(void)
+{
+    return this->limit;
+}
+
+/******************************************************************************
+ * @return Number of bytes reserved now.
+ *****************************************************************************/
+std::size_t Budget::usage(void)
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->in_use;
+}
+
+/******************************************************************************
+ * @return Largest number of bytes reserved at any time.
+ *****************************************************************************/
+std::size_t Budget::peak_usage(void)
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->peak;
+}
+
+/******************************************************************************
+ * @return Number of computations which had to wait for memory.
+ *****************************************************************************/
+std::size_t Budget::waits(void)
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->num_of_waits;
+}
+
+/******************************************************************************
+ * @return Number of computations rejected.
+ *****************************************************************************/
+std::size_t Budget::rejections(void)
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->num_of_rejections;
+}
+
+/******************************************************************************
+ * Estimate the peak memory footprint of constructing an interpolating
+ * polynomial and evaluating it. Counted are the coordinates; the hash table
+ * used to check that the x-coordinates are distinct; the vectors the
+ * construction algorithm works on, allowing for their capacities to be up to
+ * twice their sizes; and the buffer the results of the evaluation are written
+ * to a chunk at a time.
+ *
+ * @param num_of_points
+ * @param construction
+ * @param num_of_queries Number of points to evaluate the polynomial at.
+ *
+ * @return Number of bytes.
+ *****************************************************************************/
+std::size_t estimate_memory(std::size_t num_of_points, Construction construction, std::size_t num_of_queries)
+{
+    // Number of vectors of (about) as many elements as there are points which
+    // each algorithm keeps alive at the same time.
+    std::size_t num_of_vectors = 2;
+    switch(construction)
+    {
+        case Construction::lagrange:
+            num_of_vectors = 4;
+            break;
+        case Construction::newton:
+            num_of_vectors = 6;
+            break;
+        case Construction::newton_leja:
+            num_of_vectors = 8;
+            break;
+        case Construction::forward_difference:
+        case Construction::bjorck_pereyra:
+            break;
+    }
+    std::size_t const hash_table_entry = 48;
+    std::size_t const chunk = 1024;
+    std::size_t elements = 2 * num_of_points + num_of_queries + std::min(num_of_queries, chunk)
+                           + 2 * num_of_vectors * num_of_points;
+    return elements * sizeof(double) + hash_table_entry * num_of_points;
+}
+
+/******************************************************************************
+ * Estimate the peak memory footprint of constructing an interpolating
+ * polynomial and evaluating it using some arithmetic. Counted, in addition to
+ * the above, are the vectors of numbers of that arithmetic: the coordinates,
+ * the divided differences and the coefficients, allowing for their capacities
+ * to be up to twice their sizes. A `BigFloat` or a `Fraction` keeps its digits
+ * on the heap; those of the divided differences of `Fraction`s grow to about
+ * as many words as there are points.
+ *
+ * @param num_of_points
+ * @param construction Algorithm used with `double`s.
+ * @param arithmetic
+ * @param precision Number of bits of the `BigFloat` numbers.
+ * @param num_of_queries Number of points to evaluate the polynomial at.
+ *
+ * @return Number of bytes.
+ *****************************************************************************/
+std::size_t estimate_memory(std::size_t num_of_points, Construction construction, Arithmetic arithmetic,
+                            std::size_t precision, std::size_t num_of_queries)
+{
+    std::size_t const number = 64;
+    std::size_t const num_of_vectors = 8;
+    std::size_t size = 0;
+    switch(arithmetic)
+    {
+        case Arithmetic::standard:
+            break;
+        case Arithmetic::double_double:
+            size = 2 * sizeof(double);
+            construction = Construction::newton_leja;
+            break;
+        case Arithmetic::big_float:
+            size = number + precision / 8;
+            break;
+        case Arithmetic::rational:
+            size = 2 * (number + num_of_points * sizeof(std::uint64_t));
+            break;
+    }
+    return estimate_memory(num_of_points, construction, num_of_queries) + num_of_vectors * num_of_points * size;
+}
@@ -0,0 +1,111 @@
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+
+#include "Cancellation.hh"
+
+/******************************************************************************
+ * Constructor. Create a token without a deadline, which expires only when
+ * cancelled.
+ *****************************************************************************/
+Cancellation::Cancellation()
+: cancelled(false), deadline(std::chrono::steady_clock::time_point::max())
+{
+}
+
+/******************************************************************************
+ * Constructor. Create a token which expires when cancelled or when the given
+ * amount of time has passed, whichever happens first.
+ *
+ * @param timeout Time from now after which the token expires. If the deadline
+ *     would be later than the latest time which can be represented, the token
+ *     expires only when cancelled.
+ *****************************************************************************/
+Cancellation::Cancellation(std::chrono::steady_clock::duration timeout)
+: cancelled(false), deadline(std::chrono::steady_clock::now())
+{
+    if(timeout > std::chrono::steady_clock::time_point::max() - this->deadline)
+    {
+        this->deadline = std::chrono::steady_clock::time_point::max();
+    }
+    else
+    {
+        this->deadline += timeout;
+    }
+}
+
+/******************************************************************************
+ * Cancel the computations polling this token. They will stop the next time
+ * they poll it.
+ *****************************************************************************/
+void Cancellation::cancel(void)
+{
+    this->cancelled.store(true, std::memory_order_relaxed);
+}
+
+/******************************************************************************
+ * Check whether this token has been cancelled or its deadline has passed.
+ *
+ * @return `true` if it has expired, else `false`.
+ *****************************************************************************/
+bool Cancellation::expired(void) const
+{
+    return this->cancelled.load(std::memory_order_relaxed) || std::chrono::steady_clock::now() >= this->deadline;
+}
+
+/******************************************************************************
+ * Throw an exception if this token has expired.
+ *****************************************************************************/
+void Cancellation::check(void) const
+{
+    if(this->cancelled.load(std::memory_order_relaxed))
+    {
+        throw Expired("Computation cancelled.");
+    }
+    if(std::chrono::steady_clock::now() >= this->deadline)
+    {
+        throw Expired("Deadline exceeded.");
+    }
+}
+
+/******************************************************************************
+ * Throw an exception if a token has expired. Does nothing if there is no
+ * token, so that computations need not be cancellable.
+ *
+ * @param cancellation Token, or `nullptr`.
+ *****************************************************************************/
+void check(Cancellation const* cancellation)
+{
+    if(cancellation != nullptr)
+    {
+        cancellation->check();
+    }
+}
+
+/******************************************************************************
+ * Convert a number of seconds to a duration, saturating instead of
+ * overflowing.
+ *
+ * @param timeout Number of seconds.
+ *
+ * @return Duration. Zero if `timeout` is not positive, and the longest duration
+ *     if it is too large to be represented (e.g. infinite).
+ *****************************************************************************/
+std::chrono::steady_clock::duration to_duration(double timeout)
+{
+    if(std::isnan(timeout))
+    {
+        throw std::invalid_argument("Timeout is not a number.");
+    }
+    if(timeout <= 0)
+    {
+        return std::chrono::steady_clock::duration::zero();
+    }
+    std::chrono::duration<double> seconds(timeout);
+    if(seconds >= std::chrono::duration<double>(std::chrono::steady_clock::duration::max()))
+    {
+        return std::chrono::steady_clock::duration::max();
+    }
+    return std::chrono::duration_cast<std::chrono::steady_clock::duration>(seconds);
+}
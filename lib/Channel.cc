@@ -0,0 +1,523 @@
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Channel.hh"
+
+#define THROW(exception, message)  \
+{  \
+    throw exception(std::string(__FILE__) + ':' + std::to_string(__LINE__)  \
+                    + ", in function " + __func__ + ". " + message);  \
+}
+
+// Identifies a shared memory object created by `Channel` and the version of
+// its layout.
+#define CHANNEL_MAGIC 0x4c4950434831ULL
+
+// States of a slot.
+enum : std::uint32_t { slot_free, slot_submitted, slot_done };
+
+// The memory is shared between processes, so only atomics which do not need
+// a lock (and hence work at any address) may be used.
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free);
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free);
+
+// Cell of a ring, as in `Queue`, but holding only a slot index.
+struct Cell
+{
+    std::atomic<std::uint64_t> sequence;
+    std::uint32_t value;
+};
+
+// Positions in a ring. Each is on its own cache line, so that producers and
+// consumers do not contend.
+struct Ring
+{
+    alignas(64) std::atomic<std::uint64_t> head;
+    alignas(64) std::atomic<std::uint64_t> tail;
+};
+
+// Start of the shared memory object. It is followed by the cells of the ring
+// of free slots, the cells of the ring of submitted requests, the descriptors
+// and the arena, in that order.
+struct Header
+{
+    std::uint64_t magic;
+    std::uint64_t num_of_slots, slot_capacity, ring_capacity;
+    std::atomic<std::uint32_t> closed;
+    Ring free, requests;
+};
+
+/******************************************************************************
+ * Round up to a multiple of the size of a cache line.
+ *
+ * @param size
+ *
+ * @return Rounded size.
+ *****************************************************************************/
+static std::size_t align(std::size_t size)
+{
+    return (size + 63) / 64 * 64;
+}
+
+/******************************************************************************
+ * Calculate the size of the shared memory object.
+ *
+ * @param num_of_slots
+ * @param slot_capacity Number of numbers each slot can hold.
+ * @param ring_capacity Number of cells in each ring.
+ *
+ * @return Size in bytes.
+ *****************************************************************************/
+static std::size_t layout_size(std::size_t num_of_slots, std::size_t slot_capacity, std::size_t ring_capacity)
+{
+    return align(sizeof(Header)) + 2 * align(ring_capacity * sizeof(Cell))
+           + align(num_of_slots * sizeof(Descriptor)) + num_of_slots * slot_capacity * sizeof(double);
+}
+
+/******************************************************************************
+ * Back off while waiting for another process: spin briefly, then yield, then
+ * sleep. Same as in `Queue`.
+ *
+ * @param attempts Number of times waited so far. Incremented.
+ *****************************************************************************/
+static void back_off(std::size_t& attempts)
+{
+    ++attempts;
+    if(attempts < 64)
+    {
+        return;
+    }
+    if(attempts < 128)
+    {
+        std::this_thread::yield();
+        return;
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(50));
+}
+
+/******************************************************************************
+ * Push a slot index to a ring. Since there are no more slot indices than
+ * cells, there is always room.
+ *
+ * @param ring
+ * @param cells
+ * @param mask One less than the number of cells.
+ * @param value
+ *****************************************************************************/
+static void push(Ring& ring, Cell* cells, std::uint64_t mask, std::uint32_t value)
+{
+    std::uint64_t position = ring.head.load(std::memory_order_relaxed);
+    while(true)
+    {
+        Cell& cell = cells[position & mask];
+        std::uint64_t sequence = cell.sequence.load(std::memory_order_acquire);
+        if(sequence == position)
+        {
+            if(ring.head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                cell.value = value;
+                cell.sequence.store(position + 1, std::memory_order_release);
+                return;
+            }
+        }
+        else
+        {
+            position = ring.head.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+/******************************************************************************
+ * Pop a slot index from a ring if there is one.
+ *
+ * @param ring
+ * @param cells
+ * @param mask One less than the number of cells.
+ * @param value Variable to store the slot index in.
+ *
+ * @return `true` if a slot index was popped, `false` if the ring was empty.
+ *****************************************************************************/
+static bool pop(Ring& ring, Cell* cells, std::uint64_t mask, std::uint32_t& value)
+{
+    std::uint64_t position = ring.tail.load(std::memory_order_relaxed);
+    while(true)
+    {
+        Cell& cell = cells[position & mask];
+        std::uint64_t sequence = cell.sequence.load(std::memory_order_acquire);
+        if(sequence == position + 1)
+        {
+            if(ring.tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                value = cell.value;
+                cell.sequence.store(position + mask + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if(sequence < position + 1)
+        {
+            return false;
+        }
+        else
+        {
+            position = ring.tail.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+/******************************************************************************
+ * Constructor. Create a channel, replacing any existing one with the same
+ * name. It is removed when this object is destroyed.
+ *
+ * @param name Name of the shared memory object, starting with `/`.
+ * @param num_of_slots Number of requests which may be outstanding at once.
+ * @param slot_capacity Number of numbers each slot can hold. A request for `n`
+ *     points and `q` queries needs `3n + 2q`.
+ *****************************************************************************/
+Channel::Channel(std::string const& name, std::size_t num_of_slots, std::size_t slot_capacity)
+: name(name), owner(true), base(MAP_FAILED)
+{
+    if(num_of_slots == 0 || num_of_slots > UINT32_MAX || slot_capacity == 0)
+    {
+        THROW(std::invalid_argument, "Number of slots and their capacity must be positive.")
+    }
+    std::size_t ring_capacity = 2;
+    while(ring_capacity < num_of_slots)
+    {
+        ring_capacity *= 2;
+    }
+    this->length = layout_size(num_of_slots, slot_capacity, ring_capacity);
+
+    shm_unlink(name.c_str());
+    int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if(fd == -1)
+    {
+        throw std::system_error(errno, std::generic_category(), "Could not create " + name);
+    }
+    if(ftruncate(fd, this->length) == -1)
+    {
+        int error = errno;
+        ::close(fd);
+        shm_unlink(name.c_str());
+        throw std::system_error(error, std::generic_category(), "Could not resize " + name);
+    }
+    this->map(fd);
+
+    // The object is filled with zeros when resized, but the atomics must
+    // still be constructed before use.
+    this->header = new(this->base) Header;
+    this->header->num_of_slots = num_of_slots;
+    this->header->slot_capacity = slot_capacity;
+    this->header->ring_capacity = ring_capacity;
+    this->header->closed.store(0, std::memory_order_relaxed);
+    this->header->free.head.store(0, std::memory_order_relaxed);
+    this->header->free.tail.store(0, std::memory_order_relaxed);
+    this->header->requests.head.store(0, std::memory_order_relaxed);
+    this->header->requests.tail.store(0, std::memory_order_relaxed);
+    this->map(-1);
+    for(std::size_t i = 0; i < ring_capacity; ++i)
+    {
+        new(&this->free_cells[i]) Cell;
+        new(&this->request_cells[i]) Cell;
+        this->free_cells[i].sequence.store(i, std::memory_order_relaxed);
+        this->request_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    for(std::size_t i = 0; i < num_of_slots; ++i)
+    {
+        new(&this->descriptors[i]) Descriptor;
+        this->descriptors[i].state.store(slot_free, std::memory_order_relaxed);
+        push(this->header->free, this->free_cells, ring_capacity - 1, i);
+    }
+
+    // Clients check this last, so it must be written last.
+    std::atomic_thread_fence(std::memory_order_release);
+    this->header->magic = CHANNEL_MAGIC;
+}
+
+/******************************************************************************
+ * Constructor. Connect to an existing channel.
+ *
+ * @param name Name of the shared memory object, starting with `/`.
+ *****************************************************************************/
+Channel::Channel(std::string const& name)
+: name(name), owner(false), base(MAP_FAILED)
+{
+    int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if(fd == -1)
+    {
+        throw std::system_error(errno, std::generic_category(), "Could not open " + name);
+    }
+    struct stat status;
+    if(fstat(fd, &status) == -1)
+    {
+        int error = errno;
+        ::close(fd);
+        throw std::system_error(error, std::generic_category(), "Could not open " + name);
+    }
+    this->length = status.st_size;
+    if(this->length < sizeof(Header))
+    {
+        ::close(fd);
+        THROW(std::runtime_error, name + " is not a channel.")
+    }
+    this->map(fd);
+    this->header = static_cast<Header*>(this->base);
+    if(this->header->magic != CHANNEL_MAGIC
+       || this->length != layout_size(this->header->num_of_slots, this->header->slot_capacity,
+                                      this->header->ring_capacity))
+    {
+        munmap(this->base, this->length);
+        THROW(std::runtime_error, name + " is not a channel.")
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    this->map(-1);
+}
+
+/******************************************************************************
+ * Map the shared memory object, or, once it has been mapped, locate the parts
+ * following the header.
+ *
+ * @param fd File descriptor of the shared memory object, which is closed, or
+ *     -1 to locate the parts.
+ *****************************************************************************/
+void Channel::map(int fd)
+{
+    if(fd != -1)
+    {
+        this->base = mmap(nullptr, this->length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        int error = errno;
+        ::close(fd);
+        if(this->base == MAP_FAILED)
+        {
+            if(this->owner)
+            {
+                shm_unlink(this->name.c_str());
+            }
+            throw std::system_error(error, std::generic_category(), "Could not map " + this->name);
+        }
+        this->header = static_cast<Header*>(this->base);
+        return;
+    }
+    char* position = static_cast<char*>(this->base) + align(sizeof(Header));
+    std::size_t cells_size = align(this->header->ring_capacity * sizeof(Cell));
+    this->free_cells = reinterpret_cast<Cell*>(position);
+    this->request_cells = reinterpret_cast<Cell*>(position + cells_size);
+    position += 2 * cells_size;
+    this->descriptors = reinterpret_cast<Descriptor*>(position);
+    position += align(this->header->num_of_slots * sizeof(Descriptor));
+    this->arena = reinterpret_cast<double*>(position);
+}
+
+/******************************************************************************
+ * Destructor. If this object created the channel, close and remove it.
+ * Processes still connected to it may continue to use it until they
+ * disconnect.
+ *****************************************************************************/
+Channel::~Channel()
+{
+    if(this->owner)
+    {
+        this->close();
+        shm_unlink(this->name.c_str());
+    }
+    munmap(this->base, this->length);
+}
+
+/******************************************************************************
+ * @return Number of numbers each slot can hold.
+ *****************************************************************************/
+std::size_t Channel::capacity(void) const
+{
+    return this->header->slot_capacity;
+}
+
+/******************************************************************************
+ * @return Number of requests submitted but not yet received. Only approximate
+ *     if other processes are submitting or receiving.
+ *****************************************************************************/
+std::size_t Channel::pending(void) const
+{
+    std::uint64_t tail = this->header->requests.tail.load(std::memory_order_relaxed);
+    std::uint64_t head = this->header->requests.head.load(std::memory_order_relaxed);
+    return head > tail ? head - tail : 0;
+}
+
+/******************************************************************************
+ * Locate a slot in the arena, according to the sizes in its descriptor.
+ *
+ * @param index
+ *
+ * @return Slot.
+ *****************************************************************************/
+Slot Channel::slot(std::uint32_t index, std::size_t num_of_points, std::size_t num_of_queries) const
+{
+    Descriptor* descriptor = &this->descriptors[index];
+    double* xcoords = this->arena + index * this->header->slot_capacity;
+    double* ycoords = xcoords + num_of_points;
+    double* queries = ycoords + num_of_points;
+    double* coefficients = queries + num_of_queries;
+    double* values = coefficients + num_of_points;
+    return {index, descriptor, num_of_points, num_of_queries, xcoords, ycoords, queries, coefficients, values};
+}
+
+/******************************************************************************
+ * Obtain a free slot, waiting until one is available. (Client.)
+ *
+ * @param num_of_points
+ * @param num_of_queries
+ *
+ * @return Slot, into which the points and queries should be written before
+ *     submitting it.
+ *****************************************************************************/
+Slot Channel::acquire(std::size_t num_of_points, std::size_t num_of_queries)
+{
+    if(num_of_points > (this->header->slot_capacity - num_of_queries * 2) / 3
+       || 2 * num_of_queries > this->header->slot_capacity)
+    {
+        THROW(std::length_error, "Request does not fit in a slot.")
+    }
+    std::uint32_t index;
+    for(std::size_t attempts = 0;
+        !pop(this->header->free, this->free_cells, this->header->ring_capacity - 1, index);)
+    {
+        if(this->closed())
+        {
+            THROW(std::runtime_error, "Channel " + this->name + " has been closed.")
+        }
+        back_off(attempts);
+    }
+    Descriptor* descriptor = &this->descriptors[index];
+    descriptor->num_of_points = num_of_points;
+    descriptor->num_of_queries = num_of_queries;
+    return this->slot(index, num_of_points, num_of_queries);
+}
+
+/******************************************************************************
+ * Submit a request. (Client.)
+ *
+ * @param slot Slot obtained from `acquire`, filled in.
+ *****************************************************************************/
+void Channel::submit(Slot const& slot)
+{
+    slot.descriptor->state.store(slot_submitted, std::memory_order_release);
+    push(this->header->requests, this->request_cells, this->header->ring_capacity - 1, slot.index);
+}
+
+/******************************************************************************
+ * Wait for the server to respond to a request. (Client.)
+ *
+ * @param slot Slot submitted.
+ *
+ * @return `true` if the server responded, `false` if the channel was closed
+ *     first. If the former, the number of coefficients, the status and the
+ *     error message (if the status is not 0) are in the descriptor, and the
+ *     coefficients and the values at the queries are in the slot.
+ *****************************************************************************/
+bool Channel::wait(Slot const& slot)
+{
+    for(std::size_t attempts = 0; slot.descriptor->state.load(std::memory_order_acquire) != slot_done;)
+    {
+        if(this->closed())
+        {
+            return false;
+        }
+        back_off(attempts);
+    }
+    return true;
+}
+
+/******************************************************************************
+ * Return a slot to the channel after reading the response. (Client.)
+ *
+ * @param slot
+ *****************************************************************************/
+void Channel::release(Slot const& slot)
+{
+    slot.descriptor->state.store(slot_free, std::memory_order_relaxed);
+    push(this->header->free, this->free_cells, this->header->ring_capacity - 1, slot.index);
+}
+
+/******************************************************************************
+ * Receive a request, waiting until one is submitted. Several threads may
+ * receive requests at the same time. (Server.)
+ *
+ * @param slot Variable to store the slot of the request in.
+ *
+ * @return `true` if a request was received, `false` if the channel was closed
+ *     first.
+ *****************************************************************************/
+bool Channel::receive(Slot& slot)
+{
+    std::uint32_t index;
+    for(std::size_t attempts = 0; !this->closed();)
+    {
+        if(!pop(this->header->requests, this->request_cells, this->header->ring_capacity - 1, index))
+        {
+            back_off(attempts);
+            continue;
+        }
+        // The size is read once: the client could change it after it has
+        // been checked.
+        Descriptor* descriptor = &this->descriptors[index];
+        bool submitted = descriptor->state.load(std::memory_order_acquire) == slot_submitted;
+        std::uint32_t num_of_points = descriptor->num_of_points;
+        std::uint32_t num_of_queries = descriptor->num_of_queries;
+        if(submitted && 3ULL * num_of_points + 2ULL * num_of_queries <= this->header->slot_capacity)
+        {
+            slot = this->slot(index, num_of_points, num_of_queries);
+            return true;
+        }
+
+        // A misbehaving client must not make the server write outside the
+        // slot.
+        descriptor->num_of_points = descriptor->num_of_queries = 0;
+        descriptor->num_of_coefficients = 0;
+        descriptor->status = EXIT_FAILURE;
+        std::strcpy(descriptor->message, "Request does not fit in a slot.");
+        descriptor->state.store(slot_done, std::memory_order_release);
+        attempts = 0;
+    }
+    return false;
+}
+
+/******************************************************************************
+ * Respond to a request. (Server.)
+ *
+ * @param slot Slot received, with the results, number of coefficients, status
+ *     and error message (if any) filled in.
+ *****************************************************************************/
+void Channel::respond(Slot const& slot)
+{
+    slot.descriptor->state.store(slot_done, std::memory_order_release);
+}
+
+/******************************************************************************
+ * Close the channel. Clients waiting for a slot or a response and servers
+ * waiting for a request stop waiting. May be called from a signal handler.
+ *****************************************************************************/
+void Channel::close(void)
+{
+    this->header->closed.store(1, std::memory_order_release);
+}
+
+/******************************************************************************
+ * @return `true` if the channel has been closed, else `false`.
+ *****************************************************************************/
+bool Channel::closed(void) const
+{
+    return this->header->closed.load(std::memory_order_acquire) != 0;
+}
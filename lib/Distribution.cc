@@ -0,0 +1,210 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+#include "Budget.hh"
+#include "Distribution.hh"
+#include "Input.hh"
+#include "Metrics.hh"
+#include "Pipeline.hh"
+#include "Processing.hh"
+#include "Workers.hh"
+
+/******************************************************************************
+ * Process the sets of points in several files using several worker processes
+ * (see `Workers`) instead of threads, so that they do not share an allocator.
+ * This process reads the files and sends each set to a worker as soon as one
+ * has room for it, and writes the results as `batch` does. A worker which dies
+ * is replaced; a set which two workers died processing is reported as failed.
+ *
+ * @param paths Input files. `-` is standard input.
+ * @param options
+ * @param pipeline
+ * @param num_of_workers
+ * @param memory_budget Memory available to all the workers together, in
+ *     bytes. If 0, there is no limit.
+ * @param publish Function which starts publishing the metrics, called once the
+ *     workers have been forked (since no other threads may be running then).
+ *
+ * @return Exit status.
+ *****************************************************************************/
+int distribute(std::vector<char const*> const& paths, Options const& options, Pipeline const& pipeline,
+               std::size_t num_of_workers, std::size_t memory_budget, std::function<void(void)> const& publish)
+{
+    // Each worker gets a copy of this when it is forked. Sets are sent to it
+    // preceded by their numbers in their files, which appear in the error
+    // messages.
+    Budget budget(memory_budget == 0 ? 0 : std::max<std::size_t>(memory_budget / num_of_workers, 1));
+    bool recording = metrics != nullptr;
+    auto handler = [&, recording](std::string const& task, std::string& output, std::string& errors,
+                                  std::string& report)
+    {
+        // Only this process publishes metrics or records the trace (see
+        // below). What a worker measures is sent back with the results, to be
+        // merged into the metrics of this process.
+        std::unique_ptr<Metrics> measured = recording ? std::make_unique<Metrics>() : nullptr;
+        metrics = measured.get();
+        trace = nullptr;
+        char* begin;
+        std::size_t set = std::strtoull(task.data(), &begin, 10);
+        std::ostringstream out, err;
+        out.precision(12);
+        Points points;
+        int status = parse_set(begin, task.data() + task.size(), set, options, points, err);
+        if(status == EXIT_SUCCESS)
+        {
+            status = admit(points, estimate(points, options).memory, set, options, budget, out, err);
+        }
+        output = out.str();
+        errors = err.str();
+        if(measured != nullptr)
+        {
+            report = measured->dump();
+            metrics = nullptr;
+        }
+        return status;
+    };
+    std::unique_ptr<Workers> workers;
+    try
+    {
+        workers = std::make_unique<Workers>(num_of_workers, handler);
+    }
+    catch(std::system_error const& e)
+    {
+        std::cerr << e.what() << "\n";
+        return EXIT_FAILURE;
+    }
+    publish();
+
+    // In order, results are held on to until their turn comes.
+    struct Origin
+    {
+        char const* path;
+        std::size_t set;
+    };
+    std::map<std::size_t, Origin> origins;
+    std::map<std::size_t, Outcome> pending;
+    std::vector<Outcome> finished;
+    std::size_t next = 0;
+    Writer writer;
+    writer.ordered = pipeline.ordered;
+    auto flush = [&]
+    {
+        for(auto it = pending.begin(); it != pending.end() && it->first == next; it = pending.erase(it), ++next)
+        {
+            Outcome& ready = it->second;
+            Origin origin = origins[ready.index];
+            origins.erase(ready.index);
+            if(ready.abandoned)
+            {
+                ready.errors = "Set " + std::to_string(origin.set) + " was given up after two worker processes died"
+                               + " processing it. " + ready.errors;
+            }
+            writer.write(origin.path, origin.set, ready.output, ready.errors, ready.status);
+        }
+    };
+    auto drain = [&](std::size_t backlog)
+    {
+        while(workers->backlog() > backlog)
+        {
+            finished.clear();
+            workers->collect(finished);
+            for(auto& outcome: finished)
+            {
+                if(metrics != nullptr && (outcome.abandoned || !metrics->merge(outcome.report)))
+                {
+                    metrics->record(Metrics::failed);
+                }
+                pending.emplace(pipeline.ordered ? outcome.index : next + pending.size(), std::move(outcome));
+            }
+            flush();
+        }
+    };
+
+    std::size_t index = 0;
+    try
+    {
+        for(auto const& path: paths)
+        {
+            std::unique_ptr<Stream> stream;
+            std::string contents;
+            if(std::string(path) == "-")
+            {
+                stream = std::make_unique<Stream>(STDIN_FILENO);
+            }
+            else if(read_file(path, contents))
+            {
+                stream = std::make_unique<Stream>(std::move(contents));
+            }
+            std::string errors;
+            std::size_t set = 1;
+            try
+            {
+                char const* set_begin;
+                char const* set_end;
+                for(; stream != nullptr && stream->next(set_begin, set_end); ++set)
+                {
+                    drain(pipeline.depth - 1);
+                    if(trace != nullptr)
+                    {
+                        // The workers cannot write to the trace, so the set
+                        // is also parsed here to record it. One which cannot
+                        // be parsed is reported by its worker.
+                        try
+                        {
+                            Points points;
+                            read_set(set_begin, set_end, options, points);
+                            record_request(points, options);
+                        }
+                        catch(std::invalid_argument const&)
+                        {
+                        }
+                    }
+                    origins[index] = {path, set};
+                    workers->submit(index++, std::to_string(set) + "\n" + std::string(set_begin, set_end));
+                }
+            }
+            catch(std::system_error const&)
+            {
+                throw;
+            }
+            catch(std::runtime_error const& e)
+            {
+                errors = std::string(e.what()) + "\n";
+            }
+            if(stream == nullptr)
+            {
+                errors = "File " + std::string(path) + " could not be read.\n";
+            }
+            if(!errors.empty())
+            {
+                // Reported in its turn, like the results of the workers.
+                origins[index] = {path, set};
+                pending.emplace(pipeline.ordered ? index : next + pending.size(),
+                                Outcome{index, EXIT_FAILURE, "", errors, "", false});
+                ++index;
+                flush();
+            }
+        }
+        drain(0);
+    }
+    catch(std::system_error const& e)
+    {
+        std::cerr << e.what() << "\n";
+        return EXIT_FAILURE;
+    }
+    std::cerr << "Workers: " << num_of_workers << " processes, " << workers->restarts() << " restarted.\n";
+    return writer.status;
+}
@@ -0,0 +1,240 @@
+#include <cmath>
+#include <iostream>
+#include <string>
+
+#include "BigFloat.hh"
+#include "DoubleDouble.hh"
+
+/******************************************************************************
+ * Add two numbers, and find the rounding error of the sum (Knuth's
+ * algorithm).
+ *
+ * @param a
+ * @param b
+ * @param error Rounding error, such that the sum plus it is exact.
+ *
+ * @return Sum.
+ *****************************************************************************/
+static double two_sum(double a, double b, double& error)
+{
+    double sum = a + b;
+    double b_virtual = sum - a;
+    error = (a - (sum - b_virtual)) + (b - b_virtual);
+    return sum;
+}
+
+/******************************************************************************
+ * Add two numbers, the first not smaller in magnitude than the second, and
+ * find the rounding error of the sum (Dekker's algorithm).
+ *
+ * @param a
+ * @param b
+ * @param error Rounding error, such that the sum plus it is exact.
+ *
+ * @return Sum.
+ *****************************************************************************/
+static double quick_two_sum(double a, double b, double& error)
+{
+    double sum = a + b;
+    error = b - (sum - a);
+    return sum;
+}
+
+/******************************************************************************
+ * Multiply two numbers, and find the rounding error of the product using a
+ * fused multiply-add.
+ *
+ * @param a
+ * @param b
+ * @param error Rounding error, such that the product plus it is exact.
+ *
+ * @return Product.
+ *****************************************************************************/
+static double two_product(double a, double b, double& error)
+{
+    double product = a * b;
+    error = std::fma(a, b, -product);
+    return product;
+}
+
+/******************************************************************************
+ * Constructors.
+ *
+ * @param value
+ *****************************************************************************/
+DoubleDouble::DoubleDouble(int value)
+: high(value), low(0)
+{
+}
+
+DoubleDouble::DoubleDouble(double value)
+: high(value), low(0)
+{
+}
+
+/******************************************************************************
+ * Constructor.
+ *
+ * @param high
+ * @param low Need not be smaller than half a unit in the last place of
+ *     `high`; the sum is normalised.
+ *****************************************************************************/
+DoubleDouble::DoubleDouble(double high, double low)
+{
+    this->high = two_sum(high, low, this->low);
+}
+
+double DoubleDouble::get_high(void) const
+{
+    return this->high;
+}
+
+double DoubleDouble::get_low(void) const
+{
+    return this->low;
+}
+
+/******************************************************************************
+ * @return Floating-point number nearest to this number, except perhaps when
+ *     it is halfway between two of them.
+ *****************************************************************************/
+double DoubleDouble::to_double(void) const
+{
+    return this->high;
+}
+
+/******************************************************************************
+ * @return Decimal representation of this number, with enough significant
+ *     digits to tell it apart from every other number.
+ *****************************************************************************/
+std::string DoubleDouble::to_string(void) const
+{
+    if(!std::isfinite(this->high))
+    {
+        return std::to_string(this->high);
+    }
+    return (BigFloat(this->high, 107) + BigFloat(this->low, 107)).to_string();
+}
+
+/******************************************************************************
+ * Add two numbers. The low parts are added separately from the high ones, so
+ * that the relative error is small even if the sum cancels.
+ *
+ * @param a
+ * @param b
+ *
+ * @return Sum.
+ *****************************************************************************/
+DoubleDouble operator+(DoubleDouble const& a, DoubleDouble const& b)
+{
+    double high_error, low_error;
+    double high = two_sum(a.high, b.high, high_error);
+    double low = two_sum(a.low, b.low, low_error);
+    high_error += low;
+    high = quick_two_sum(high, high_error, high_error);
+    high_error += low_error;
+    DoubleDouble result;
+    result.high = quick_two_sum(high, high_error, result.low);
+    return result;
+}
+
+/******************************************************************************
+ * Multiply two numbers. The product of the low parts is too small to matter.
+ *
+ * @param a
+ * @param b
+ *
+ * @return Product.
+ *****************************************************************************/
+DoubleDouble operator*(DoubleDouble const& a, DoubleDouble const& b)
+{
+    double error;
+    double high = two_product(a.high, b.high, error);
+    error += a.high * b.low + a.low * b.high;
+    DoubleDouble result;
+    result.high = quick_two_sum(high, error, result.low);
+    return result;
+}
+
+/******************************************************************************
+ * Divide two numbers using long division: three quotient digits, each a
+ * `double`, each correcting the remainder of the previous ones.
+ *
+ * @param a
+ * @param b
+ *
+ * @return Quotient.
+ *****************************************************************************/
+DoubleDouble operator/(DoubleDouble const& a, DoubleDouble const& b)
+{
+    double first = a.high / b.high;
+    DoubleDouble remainder = a - b * first;
+    double second = remainder.high / b.high;
+    remainder -= b * second;
+    double third = remainder.high / b.high;
+    DoubleDouble result;
+    result.high = quick_two_sum(first, second, result.low);
+    return result + third;
+}
+
+DoubleDouble operator-(DoubleDouble const& a)
+{
+    DoubleDouble result;
+    result.high = -a.high;
+    result.low = -a.low;
+    return result;
+}
+
+/******************************************************************************
+ * Compare two numbers. Both are normalised, so equal numbers have equal
+ * parts.
+ *****************************************************************************/
+bool operator==(DoubleDouble const& a, DoubleDouble const& b)
+{
+    return a.high == b.high && a.low == b.low;
+}
+
+bool operator<(DoubleDouble const& a, DoubleDouble const& b)
+{
+    return a.high < b.high || (a.high == b.high && a.low < b.low);
+}
+
+DoubleDouble operator-(DoubleDouble const& a, DoubleDouble const& b)
+{
+    return a + -b;
+}
+
+void operator+=(DoubleDouble& a, DoubleDouble const& b)
+{
+    a = a + b;
+}
+
+void operator-=(DoubleDouble& a, DoubleDouble const& b)
+{
+    a = a - b;
+}
+
+void operator*=(DoubleDouble& a, DoubleDouble const& b)
+{
+    a = a * b;
+}
+
+void operator/=(DoubleDouble& a, DoubleDouble const& b)
+{
+    a = a / b;
+}
+
+bool operator!=(DoubleDouble const& a, DoubleDouble const& b)
+{
+    return !(a == b);
+}
+
+DoubleDouble abs(DoubleDouble const& a)
+{
+    return a.get_high() < 0 ? -a : a;
+}
+
+std::ostream& operator<<(std::ostream& ostream, DoubleDouble const& a)
+{
+    return ostream << a.to_string();
+}
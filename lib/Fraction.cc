@@ -0,0 +1,387 @@
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "Fraction.hh"
+#include "Rational.hh"
+
+#define THROW(exception, message)  \
+{  \
+    throw exception(std::string(__FILE__) + ':' + std::to_string(__LINE__)  \
+                    + ", in function " + __func__ + ". " + message);  \
+}
+
+// 128-bit integers are an extension of GCC and Clang.
+__extension__ typedef __int128 Wide;
+__extension__ typedef unsigned __int128 UnsignedWide;
+
+/******************************************************************************
+ * Find the magnitude of a 128-bit integer.
+ *
+ * @param a
+ *
+ * @return Magnitude.
+ *****************************************************************************/
+static UnsignedWide magnitude(Wide a)
+{
+    return a < 0 ? UnsignedWide(0) - static_cast<UnsignedWide>(a) : static_cast<UnsignedWide>(a);
+}
+
+/******************************************************************************
+ * Find the greatest common divisor of a 128-bit integer and a 64-bit one.
+ *
+ * @param a
+ * @param b Must be positive.
+ *
+ * @return Greatest common divisor.
+ *****************************************************************************/
+static std::uint64_t wide_gcd(Wide a, std::uint64_t b)
+{
+    return binary_gcd(static_cast<std::uint64_t>(magnitude(a) % b), b);
+}
+
+/******************************************************************************
+ * Convert a 128-bit integer to a big integer.
+ *
+ * @param a
+ *
+ * @return `a`.
+ *****************************************************************************/
+static BigInteger widen(Wide a)
+{
+    UnsignedWide m = magnitude(a);
+    BigInteger result;
+    for(int shift = 96; shift >= 0; shift -= 32)
+    {
+        result = (result << 32) + BigInteger(static_cast<long long>((m >> shift) & 0xFFFFFFFFU));
+    }
+    return a < 0 ? -result : result;
+}
+
+/******************************************************************************
+ * @param a
+ *
+ * @return `true` if `a` fits in 64 bits, its negation included, else `false`.
+ *****************************************************************************/
+static bool fits(Wide a)
+{
+    return a > std::numeric_limits<std::int64_t>::min() && a <= std::numeric_limits<std::int64_t>::max();
+}
+
+/******************************************************************************
+ * @param a
+ *
+ * @return `true` if `a` fits in 64 bits, its negation included, else `false`.
+ *****************************************************************************/
+static bool fits(BigInteger const& a)
+{
+    return a.bit_length() < 64;
+}
+
+/******************************************************************************
+ * Constructors.
+ *
+ * @param value
+ *****************************************************************************/
+Fraction::Fraction(int value)
+: numerator(value), denominator(1)
+{
+}
+
+Fraction::Fraction(long long value)
+: numerator(value), denominator(1)
+{
+    if(value == std::numeric_limits<long long>::min())
+    {
+        *this = Fraction(Rational(value));
+    }
+}
+
+/******************************************************************************
+ * Constructor. Reduce the fraction to lowest terms.
+ *
+ * @param numerator
+ * @param denominator Must not be zero.
+ *****************************************************************************/
+Fraction::Fraction(long long numerator, long long denominator)
+{
+    if(denominator == 0)
+    {
+        THROW(std::domain_error, "Denominator is zero.")
+    }
+    Wide n = numerator, d = denominator;
+    if(d < 0)
+    {
+        n = -n;
+        d = -d;
+    }
+    std::uint64_t divisor = wide_gcd(n, static_cast<std::uint64_t>(d));
+    n /= static_cast<Wide>(divisor);
+    d /= static_cast<Wide>(divisor);
+    if(fits(n) && fits(d))
+    {
+        this->numerator = static_cast<std::int64_t>(n);
+        this->denominator = static_cast<std::int64_t>(d);
+        return;
+    }
+    *this = Fraction(Rational(widen(n), widen(d)));
+}
+
+/******************************************************************************
+ * Constructor. Every finite floating-point number is a rational number with a
+ * power of 2 as its denominator; this is that number, exactly.
+ *
+ * @param value Must be finite.
+ *****************************************************************************/
+Fraction::Fraction(double value)
+: Fraction(Rational(value))
+{
+}
+
+/******************************************************************************
+ * Constructor.
+ *
+ * @param value
+ *****************************************************************************/
+Fraction::Fraction(Rational const& value)
+: numerator(0), denominator(1)
+{
+    if(fits(value.get_numerator()) && fits(value.get_denominator()))
+    {
+        this->numerator = value.get_numerator().to_long_long();
+        this->denominator = value.get_denominator().to_long_long();
+        return;
+    }
+    this->big = std::make_shared<Rational const>(value);
+}
+
+/******************************************************************************
+ * @return `true` if this number does not fit in 64 bits, else `false`.
+ *****************************************************************************/
+bool Fraction::promoted(void) const
+{
+    return this->big != nullptr;
+}
+
+/******************************************************************************
+ * @return -1, 0 or 1 as this number is negative, zero or positive.
+ *****************************************************************************/
+int Fraction::sign(void) const
+{
+    if(this->big != nullptr)
+    {
+        return this->big->sign();
+    }
+    return (this->numerator > 0) - (this->numerator < 0);
+}
+
+/******************************************************************************
+ * @return This number.
+ *****************************************************************************/
+Rational Fraction::to_rational(void) const
+{
+    if(this->big != nullptr)
+    {
+        return *this->big;
+    }
+    return Rational(BigInteger(this->numerator), BigInteger(this->denominator));
+}
+
+/******************************************************************************
+ * @return Floating-point number nearest to this number.
+ *****************************************************************************/
+double Fraction::to_double(void) const
+{
+    std::int64_t const exact = 1LL << std::numeric_limits<double>::digits;
+    if(this->big == nullptr && -exact <= this->numerator && this->numerator <= exact && this->denominator <= exact)
+    {
+        // Both are exact, so the quotient is correctly rounded.
+        return static_cast<double>(this->numerator) / this->denominator;
+    }
+    return this->to_rational().to_double();
+}
+
+/******************************************************************************
+ * @return This number as `numerator/denominator`, or as an integer if the
+ *     denominator is 1.
+ *****************************************************************************/
+std::string Fraction::to_string(void) const
+{
+    if(this->big != nullptr)
+    {
+        return this->big->to_string();
+    }
+    if(this->denominator == 1)
+    {
+        return std::to_string(this->numerator);
+    }
+    return std::to_string(this->numerator) + '/' + std::to_string(this->denominator);
+}
+
+/******************************************************************************
+ * Add two fractions. Dividing the denominators by their greatest common
+ * divisor first keeps the numbers small: the numerator of the sum then needs
+ * at most 127 bits.
+ *
+ * @param a
+ * @param b
+ *
+ * @return Sum.
+ *****************************************************************************/
+Fraction operator+(Fraction const& a, Fraction const& b)
+{
+    if(a.big != nullptr || b.big != nullptr)
+    {
+        return Fraction(a.to_rational() + b.to_rational());
+    }
+    std::uint64_t divisor = binary_gcd(a.denominator, b.denominator);
+    Wide a_cofactor = a.denominator / divisor, b_cofactor = b.denominator / divisor;
+    Wide numerator = a.numerator * b_cofactor + b.numerator * a_cofactor;
+    if(numerator == 0)
+    {
+        return Fraction();
+    }
+    std::uint64_t common = wide_gcd(numerator, divisor);
+    numerator /= static_cast<Wide>(common);
+    Wide denominator = a_cofactor * (b.denominator / static_cast<Wide>(common));
+    Fraction result;
+    if(fits(numerator) && fits(denominator))
+    {
+        result.numerator = static_cast<std::int64_t>(numerator);
+        result.denominator = static_cast<std::int64_t>(denominator);
+        return result;
+    }
+    result.big = std::make_shared<Rational const>(Rational(widen(numerator), widen(denominator)));
+    return result;
+}
+
+/******************************************************************************
+ * Multiply two fractions. Cancelling each numerator against the other
+ * denominator first leaves the product in lowest terms.
+ *
+ * @param a
+ * @param b
+ *
+ * @return Product.
+ *****************************************************************************/
+Fraction operator*(Fraction const& a, Fraction const& b)
+{
+    if(a.big != nullptr || b.big != nullptr)
+    {
+        return Fraction(a.to_rational() * b.to_rational());
+    }
+    if(a.numerator == 0 || b.numerator == 0)
+    {
+        return Fraction();
+    }
+    std::int64_t ad = binary_gcd(static_cast<std::uint64_t>(magnitude(a.numerator)), b.denominator);
+    std::int64_t bc = binary_gcd(static_cast<std::uint64_t>(magnitude(b.numerator)), a.denominator);
+    Wide numerator = static_cast<Wide>(a.numerator / ad) * (b.numerator / bc);
+    Wide denominator = static_cast<Wide>(a.denominator / bc) * (b.denominator / ad);
+    Fraction result;
+    if(fits(numerator) && fits(denominator))
+    {
+        result.numerator = static_cast<std::int64_t>(numerator);
+        result.denominator = static_cast<std::int64_t>(denominator);
+        return result;
+    }
+    result.big = std::make_shared<Rational const>(Rational(widen(numerator), widen(denominator)));
+    return result;
+}
+
+/******************************************************************************
+ * @param a
+ *
+ * @return Negation.
+ *****************************************************************************/
+Fraction operator-(Fraction const& a)
+{
+    if(a.big != nullptr)
+    {
+        return Fraction(-*a.big);
+    }
+    Fraction result = a;
+    result.numerator = -result.numerator;
+    return result;
+}
+
+/******************************************************************************
+ * @param a Must not be zero.
+ *
+ * @return Reciprocal.
+ *****************************************************************************/
+Fraction reciprocal(Fraction const& a)
+{
+    if(a.big != nullptr)
+    {
+        return Fraction(reciprocal(*a.big));
+    }
+    if(a.numerator == 0)
+    {
+        THROW(std::domain_error, "Division by zero.")
+    }
+    Fraction result;
+    result.numerator = a.numerator < 0 ? -a.denominator : a.denominator;
+    result.denominator = a.numerator < 0 ? -a.numerator : a.numerator;
+    return result;
+}
+
+/******************************************************************************
+ * Compare two fractions. Both are in lowest terms, and a promoted fraction
+ * never fits in 64 bits, so equal fractions have equal representations.
+ *
+ * @param a
+ * @param b
+ *
+ * @return `true` if they are equal, else `false`.
+ *****************************************************************************/
+bool operator==(Fraction const& a, Fraction const& b)
+{
+    if(a.big != nullptr || b.big != nullptr)
+    {
+        return a.big != nullptr && b.big != nullptr && *a.big == *b.big;
+    }
+    return a.numerator == b.numerator && a.denominator == b.denominator;
+}
+
+Fraction operator-(Fraction const& a, Fraction const& b)
+{
+    return a + -b;
+}
+
+Fraction operator/(Fraction const& a, Fraction const& b)
+{
+    return a * reciprocal(b);
+}
+
+void operator+=(Fraction& a, Fraction const& b)
+{
+    a = a + b;
+}
+
+void operator-=(Fraction& a, Fraction const& b)
+{
+    a = a - b;
+}
+
+void operator*=(Fraction& a, Fraction const& b)
+{
+    a = a * b;
+}
+
+void operator/=(Fraction& a, Fraction const& b)
+{
+    a = a / b;
+}
+
+bool operator!=(Fraction const& a, Fraction const& b)
+{
+    return !(a == b);
+}
+
+std::ostream& operator<<(std::ostream& ostream, Fraction const& a)
+{
+    return ostream << a.to_string();
+}
@@ -0,0 +1,291 @@
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Input.hh"
+
+#define THROW(exception, message)  \
+{  \
+    throw exception(std::string(__FILE__) + ':' + std::to_string(__LINE__)  \
+                    + ", in function " + __func__ + ". " + message);  \
+}
+
+/******************************************************************************
+ * Constructor.
+ *
+ * @param fd File descriptor to read from. It is not closed by this object.
+ *****************************************************************************/
+Stream::Stream(int fd)
+: fd(fd), eof(false), consumed(0), scanned(0), blank(true)
+{
+}
+
+/******************************************************************************
+ * Constructor.
+ *
+ * @param contents Complete input, already read.
+ *****************************************************************************/
+Stream::Stream(std::string&& contents)
+: fd(-1), eof(true), buffer(std::move(contents)), consumed(0), scanned(0), blank(true)
+{
+}
+
+/******************************************************************************
+ * Obtain the next block. Blank lines before it are skipped. If the file
+ * descriptor is a pipe, this waits only until the block has been read, not
+ * until the writer closes it.
+ *
+ * @param begin Variable to store a pointer to the first character of the
+ *     block in.
+ * @param end Variable to store a pointer past the last character of the block
+ *     in. Both pointers remain valid until the next call.
+ *
+ * @return `true` if a block was obtained, `false` if there are no more.
+ *****************************************************************************/
+bool Stream::next(char const*& begin, char const*& end)
+{
+    // Discard the blocks handed out earlier once they make up most of the
+    // buffer, so that the cost of doing so is linear in the input size.
+    if(2 * this->consumed > this->buffer.size())
+    {
+        this->buffer.erase(0, this->consumed);
+        this->scanned -= this->consumed;
+        this->consumed = 0;
+    }
+    while(true)
+    {
+        // Examine the complete lines not yet examined. The block ends at the
+        // first blank line after a line which is not blank.
+        std::size_t newline;
+        while((newline = this->buffer.find('\n', this->scanned)) != std::string::npos)
+        {
+            std::size_t line = this->scanned;
+            this->scanned = newline + 1;
+            bool blank_line = this->buffer.find_first_not_of(" \t\r", line) >= newline;
+            if(blank_line && this->blank)
+            {
+                this->consumed = this->scanned;
+            }
+            else if(blank_line)
+            {
+                begin = this->buffer.data() + this->consumed;
+                end = this->buffer.data() + line;
+                this->consumed = this->scanned;
+                this->blank = true;
+                return true;
+            }
+            this->blank = this->blank && blank_line;
+        }
+
+        // The last block need not be followed by a blank line, or even end
+        // with a newline.
+        if(this->eof)
+        {
+            this->scanned = this->buffer.size();
+            this->blank = this->blank && this->buffer.find_first_not_of(" \t\r", this->consumed) == std::string::npos;
+            if(this->blank)
+            {
+                return false;
+            }
+            begin = this->buffer.data() + this->consumed;
+            end = this->buffer.data() + this->buffer.size();
+            this->consumed = this->buffer.size();
+            this->blank = true;
+            return true;
+        }
+
+        char chunk[1 << 16];
+        ssize_t count = read(this->fd, chunk, sizeof chunk);
+        if(count < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if(count < 0)
+        {
+            std::string message = "Could not read the input. " + std::string(std::strerror(errno)) + ".";
+            THROW(std::runtime_error, message)
+        }
+        this->eof = (count == 0);
+        this->buffer.append(chunk, count);
+    }
+}
+
+/******************************************************************************
+ * Read the whole of a file. The kernel is asked to read ahead, and, if the
+ * file is a regular file, it is read with `pread` into a buffer of its size,
+ * so that it is usually read in a single system call.
+ *
+ * @param path
+ * @param contents String to store the contents of the file in.
+ *
+ * @return `true` if the file was read, else `false`.
+ *****************************************************************************/
+bool read_file(char const* path, std::string& contents)
+{
+    int fd = open(path, O_RDONLY);
+    if(fd == -1)
+    {
+        return false;
+    }
+    struct stat status;
+    bool regular = fstat(fd, &status) == 0 && S_ISREG(status.st_mode);
+    if(regular)
+    {
+        posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+        posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+    }
+
+    // One byte more than the size of a regular file, so that the end of the
+    // file is detected without growing the buffer.
+    contents.resize(regular ? status.st_size + 1 : 1 << 16);
+    std::size_t size = 0;
+    ssize_t count;
+    while(true)
+    {
+        if(size == contents.size())
+        {
+            contents.resize(2 * size);
+        }
+        count = regular ? pread(fd, &contents[size], contents.size() - size, size)
+                        : read(fd, &contents[size], contents.size() - size);
+        if(count < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if(count <= 0)
+        {
+            break;
+        }
+        size += count;
+    }
+    contents.resize(size);
+    close(fd);
+    return count == 0;
+}
+
+/******************************************************************************
+ * Skip spaces and tabs.
+ *
+ * @param begin
+ * @param end
+ *
+ * @return Pointer to the first character which is neither, or `end`.
+ *****************************************************************************/
+static char const* skip_blanks(char const* begin, char const* end)
+{
+    while(begin != end && (*begin == ' ' || *begin == '\t' || *begin == '\r'))
+    {
+        ++begin;
+    }
+    return begin;
+}
+
+/******************************************************************************
+ * Parse a number. Unlike `std::strtod`, this neither depends on the locale nor
+ * requires the input to be null-terminated.
+ *
+ * @param begin Pointer to the first character of the number.
+ * @param end
+ * @param number Variable to store the number in.
+ *
+ * @return Pointer to the character after the number, or `nullptr` if there is
+ *     no number, or it is out of range or not finite. (`std::from_chars`
+ *     accepts "nan", "inf" and "infinity", none of which can be interpolated.)
+ *****************************************************************************/
+static char const* parse_number(char const* begin, char const* end, double& number)
+{
+    // `std::from_chars` does not accept a leading plus sign.
+    if(begin != end && *begin == '+')
+    {
+        ++begin;
+    }
+    auto result = std::from_chars(begin, end, number);
+    if(result.ec != std::errc() || !std::isfinite(number))
+    {
+        return nullptr;
+    }
+    return result.ptr;
+}
+
+/******************************************************************************
+ * Parse points and x-coordinates to evaluate at, one per line. Blank lines
+ * are ignored.
+ *
+ * @param begin Pointer to the first character of the input.
+ * @param end Pointer past the last character of the input.
+ * @param points Object to append the points and x-coordinates to.
+ *****************************************************************************/
+void parse_points(char const* begin, char const* end, Points& points)
+{
+    for(std::size_t line = 1; begin != end; ++line)
+    {
+        double numbers[2];
+        int count = 0;
+        while((begin = skip_blanks(begin, end)) != end && *begin != '\n')
+        {
+            char const* next = count < 2 ? parse_number(begin, end, numbers[count]) : nullptr;
+            if(next == nullptr)
+            {
+                std::string message = "Expected one or two finite numbers on line " + std::to_string(line) + ".";
+                THROW(std::invalid_argument, message)
+            }
+            begin = next;
+            ++count;
+        }
+        if(begin != end)
+        {
+            ++begin;
+        }
+        if(count == 2)
+        {
+            points.xcoords.push_back(numbers[0]);
+            points.ycoords.push_back(numbers[1]);
+        }
+        else if(count == 1)
+        {
+            points.queries.push_back(numbers[0]);
+        }
+    }
+}
+
+/******************************************************************************
+ * Parse numbers separated by whitespace.
+ *
+ * @param begin Pointer to the first character of the input.
+ * @param end Pointer past the last character of the input.
+ * @param numbers Vector to append the numbers to.
+ *****************************************************************************/
+void parse_numbers(char const* begin, char const* end, std::vector<double>& numbers)
+{
+    std::size_t line = 1;
+    while((begin = skip_blanks(begin, end)) != end)
+    {
+        if(*begin == '\n')
+        {
+            ++begin;
+            ++line;
+            continue;
+        }
+        double number;
+        char const* next = parse_number(begin, end, number);
+        if(next == nullptr)
+        {
+            std::string message = "Expected a finite number on line " + std::to_string(line) + ", but found '"
+                                  + std::string(1, *begin) + "'.";
+            THROW(std::invalid_argument, message)
+        }
+        numbers.push_back(number);
+        begin = next;
+    }
+}
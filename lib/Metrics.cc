@@ -0,0 +1,684 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "Metrics.hh"
+#include "Tuning.hh"
+
+// Names of the algorithms, as they appear in the labels of the metrics.
+static char const* construction_names[] =
+{
+    "lagrange",
+    "newton",
+    "newton_leja",
+    "forward_difference",
+    "bjorck_pereyra",
+};
+
+// Names of the arithmetic, as they appear in the labels of the metrics.
+static char const* arithmetic_names[] =
+{
+    "double",
+    "double_double",
+    "bigfloat",
+    "rational",
+};
+
+// Exponents of the powers of two (of nanoseconds) which are the upper bounds
+// of the buckets of the histograms exposed: from about a microsecond to about
+// a minute.
+#define EXPOSED_MIN_EXPONENT 10
+#define EXPOSED_MAX_EXPONENT 36
+
+/******************************************************************************
+ * Constructor.
+ *****************************************************************************/
+Histogram::Histogram()
+: total(0), sum(0)
+{
+    for(auto& count: this->counts)
+    {
+        count.store(0, std::memory_order_relaxed);
+    }
+}
+
+/******************************************************************************
+ * Find the bucket a value falls in.
+ *
+ * @param value
+ *
+ * @return Index of the bucket.
+ *****************************************************************************/
+std::size_t Histogram::bucket(std::uint64_t value)
+{
+    if(value < sub_buckets)
+    {
+        return value;
+    }
+    int exponent = 63 - __builtin_clzll(value);
+    int shift = exponent - 4;
+    return (exponent - 3) * sub_buckets + ((value >> shift) - sub_buckets);
+}
+
+/******************************************************************************
+ * Find the smallest value greater than all the values in a bucket.
+ *
+ * @param bucket Index of the bucket.
+ *
+ * @return Upper bound. Saturated if it cannot be represented.
+ *****************************************************************************/
+std::uint64_t Histogram::upper_bound(std::size_t bucket)
+{
+    if(bucket < sub_buckets)
+    {
+        return bucket + 1;
+    }
+    int shift = bucket / sub_buckets - 1;
+    std::uint64_t sub_bucket = bucket % sub_buckets;
+    if(shift >= 59 && sub_bucket == sub_buckets - 1)
+    {
+        return std::numeric_limits<std::uint64_t>::max();
+    }
+    return (sub_buckets + sub_bucket + 1) << shift;
+}
+
+/******************************************************************************
+ * Record a value. Only the thread owning this histogram may call this.
+ *
+ * @param value
+ *****************************************************************************/
+void Histogram::record(std::uint64_t value)
+{
+    // There is only one writer, so a load followed by a store suffices, and
+    // is cheaper than an atomic increment.
+    auto& count = this->counts[bucket(value)];
+    count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    this->total.store(this->total.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    this->sum.store(this->sum.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+/******************************************************************************
+ * Add the values recorded in another histogram to this one. Only the thread
+ * owning this histogram may call this.
+ *
+ * @param other
+ *****************************************************************************/
+void Histogram::merge(Histogram const& other)
+{
+    for(std::size_t i = 0; i < num_of_buckets; ++i)
+    {
+        std::uint64_t count = other.counts[i].load(std::memory_order_relaxed);
+        this->counts[i].store(this->counts[i].load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+    }
+    this->total.store(this->total.load(std::memory_order_relaxed) + other.total.load(std::memory_order_relaxed),
+                      std::memory_order_relaxed);
+    this->sum.store(this->sum.load(std::memory_order_relaxed) + other.sum.load(std::memory_order_relaxed),
+                    std::memory_order_relaxed);
+}
+
+/******************************************************************************
+ * Append a number to a dump, in the byte order of this machine.
+ *
+ * @param out
+ * @param word
+ *****************************************************************************/
+static void append(std::string& out, std::uint64_t word)
+{
+    out.append(reinterpret_cast<char const*>(&word), sizeof word);
+}
+
+/******************************************************************************
+ * Read a number from a dump.
+ *
+ * @param position Where the number starts. Advanced past it.
+ * @param end End of the dump.
+ * @param word Where to store the number.
+ *
+ * @return `true` if it was read, `false` if the dump ended first.
+ *****************************************************************************/
+static bool extract(char const*& position, char const* end, std::uint64_t& word)
+{
+    if(static_cast<std::size_t>(end - position) < sizeof word)
+    {
+        return false;
+    }
+    std::memcpy(&word, position, sizeof word);
+    position += sizeof word;
+    return true;
+}
+
+/******************************************************************************
+ * Append the values recorded to a dump: their number, their sum and the
+ * number of buckets which are not empty, followed by the index and count of
+ * each of those.
+ *
+ * @param out
+ *****************************************************************************/
+void Histogram::dump(std::string& out) const
+{
+    std::size_t num_of_used_buckets = 0;
+    for(auto const& count: this->counts)
+    {
+        num_of_used_buckets += count.load(std::memory_order_relaxed) != 0;
+    }
+    append(out, this->total.load(std::memory_order_relaxed));
+    append(out, this->sum.load(std::memory_order_relaxed));
+    append(out, num_of_used_buckets);
+    for(std::size_t i = 0; i < num_of_buckets; ++i)
+    {
+        std::uint64_t count = this->counts[i].load(std::memory_order_relaxed);
+        if(count != 0)
+        {
+            append(out, i);
+            append(out, count);
+        }
+    }
+}
+
+/******************************************************************************
+ * Add the values in a dump made by `dump` to this histogram. Only the thread
+ * owning this histogram may call this.
+ *
+ * @param position Where the dump starts. Advanced past it.
+ * @param end End of the dump.
+ *
+ * @return `true` if the dump was read, `false` if it is malformed.
+ *****************************************************************************/
+bool Histogram::load(char const*& position, char const* end)
+{
+    std::uint64_t total, sum, num_of_used_buckets;
+    if(!extract(position, end, total) || !extract(position, end, sum) || !extract(position, end, num_of_used_buckets))
+    {
+        return false;
+    }
+    for(std::uint64_t i = 0; i < num_of_used_buckets; ++i)
+    {
+        std::uint64_t bucket, count;
+        if(!extract(position, end, bucket) || !extract(position, end, count) || bucket >= num_of_buckets)
+        {
+            return false;
+        }
+        auto& counter = this->counts[bucket];
+        counter.store(counter.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+    }
+    this->total.store(this->total.load(std::memory_order_relaxed) + total, std::memory_order_relaxed);
+    this->sum.store(this->sum.load(std::memory_order_relaxed) + sum, std::memory_order_relaxed);
+    return true;
+}
+
+/******************************************************************************
+ * @return Number of values recorded.
+ *****************************************************************************/
+std::uint64_t Histogram::count(void) const
+{
+    return this->total.load(std::memory_order_relaxed);
+}
+
+/******************************************************************************
+ * @return Sum of the values recorded.
+ *****************************************************************************/
+std::uint64_t Histogram::total_value(void) const
+{
+    return this->sum.load(std::memory_order_relaxed);
+}
+
+/******************************************************************************
+ * Count the values recorded in a bucket and those before it.
+ *
+ * @param bucket Index of the bucket.
+ *
+ * @return Number of values.
+ *****************************************************************************/
+std::uint64_t Histogram::count_below(std::size_t bucket) const
+{
+    std::uint64_t count = 0;
+    for(std::size_t i = 0; i <= bucket && i < num_of_buckets; ++i)
+    {
+        count += this->counts[i].load(std::memory_order_relaxed);
+    }
+    return count;
+}
+
+/******************************************************************************
+ * Estimate a quantile of the values recorded.
+ *
+ * @param fraction Fraction of the values which should be at most the quantile,
+ *     between 0 and 1.
+ *
+ * @return Upper bound of the bucket containing the quantile, or 0 if nothing
+ *     was recorded.
+ *****************************************************************************/
+std::uint64_t Histogram::quantile(double fraction) const
+{
+    std::uint64_t total = 0;
+    for(auto const& count: this->counts)
+    {
+        total += count.load(std::memory_order_relaxed);
+    }
+    if(total == 0)
+    {
+        return 0;
+    }
+    std::uint64_t rank = std::max<std::uint64_t>(std::ceil(fraction * total), 1);
+    std::uint64_t count = 0;
+    for(std::size_t i = 0; i < num_of_buckets; ++i)
+    {
+        count += this->counts[i].load(std::memory_order_relaxed);
+        if(count >= rank)
+        {
+            return upper_bound(i);
+        }
+    }
+    return upper_bound(num_of_buckets - 1);
+}
+
+/******************************************************************************
+ * Constructor.
+ *****************************************************************************/
+Metrics::Shard::Shard()
+: points(0), queries(0)
+{
+    for(auto& count: this->requests)
+    {
+        count.store(0, std::memory_order_relaxed);
+    }
+}
+
+/******************************************************************************
+ * Constructor.
+ *****************************************************************************/
+Metrics::Metrics()
+: stopped(false)
+{
+    static std::atomic<std::uint64_t> num_of_objects(0);
+    this->identity = ++num_of_objects;
+}
+
+/******************************************************************************
+ * Destructor. Stop publishing, if this object was.
+ *****************************************************************************/
+Metrics::~Metrics()
+{
+    this->stop();
+}
+
+/******************************************************************************
+ * Obtain the shard of the calling thread, creating it on first use. A thread
+ * which records into several objects in turn gets a new shard at every turn,
+ * so it should not.
+ *
+ * @return Shard.
+ *****************************************************************************/
+Metrics::Shard& Metrics::local(void)
+{
+    // Objects may be created at the address of one destroyed earlier, so the
+    // shard remembered is tagged with a number unique to its object.
+    thread_local std::uint64_t owner = 0;
+    thread_local Shard* shard = nullptr;
+    if(owner != this->identity)
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->shards.push_back(std::make_unique<Shard>());
+        shard = this->shards.back().get();
+        owner = this->identity;
+    }
+    return *shard;
+}
+
+/******************************************************************************
+ * Increment a counter owned by the calling thread.
+ *
+ * @param counter
+ * @param amount
+ *****************************************************************************/
+static void increment(std::atomic<std::uint64_t>& counter, std::uint64_t amount=1)
+{
+    counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+/******************************************************************************
+ * Record the construction of an interpolating polynomial.
+ *
+ * @param construction Algorithm used.
+ * @param arithmetic Numbers it was used with.
+ * @param num_of_points
+ * @param elapsed Time taken.
+ *****************************************************************************/
+void Metrics::record(Construction construction, Arithmetic arithmetic, std::size_t num_of_points,
+                     std::chrono::steady_clock::duration elapsed)
+{
+    Shard& shard = this->local();
+    shard.construction[static_cast<int>(arithmetic)][static_cast<int>(construction)].record(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    increment(shard.points, num_of_points);
+}
+
+/******************************************************************************
+ * Record the evaluation of an interpolating polynomial.
+ *
+ * @param num_of_queries Number of x-coordinates it was evaluated at.
+ * @param elapsed Time taken.
+ *****************************************************************************/
+void Metrics::record(std::size_t num_of_queries, std::chrono::steady_clock::duration elapsed)
+{
+    Shard& shard = this->local();
+    shard.evaluation.record(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    increment(shard.queries, num_of_queries);
+}
+
+/******************************************************************************
+ * Record the completion of a request.
+ *
+ * @param outcome
+ *****************************************************************************/
+void Metrics::record(Outcome outcome)
+{
+    increment(this->local().requests[outcome]);
+}
+
+/******************************************************************************
+ * Register a value which can go up and down, kept elsewhere.
+ *
+ * @param name Name of the metric.
+ * @param help Description of the metric.
+ * @param labels Labels of this value (such as `queue="input"`), or an empty
+ *     string. Values with the same name must be registered one after the
+ *     other.
+ * @param read Function returning the value. Called from any thread.
+ *****************************************************************************/
+void Metrics::gauge(std::string const& name, std::string const& help, std::string const& labels,
+                    std::function<double(void)> read)
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->readings.push_back({name, help, "gauge", labels, std::move(read)});
+}
+
+/******************************************************************************
+ * Register a value which only goes up, kept elsewhere.
+ *
+ * @param name Name of the metric.
+ * @param help Description of the metric.
+ * @param labels Labels of this value, or an empty string.
+ * @param read Function returning the value. Called from any thread.
+ *****************************************************************************/
+void Metrics::counter(std::string const& name, std::string const& help, std::string const& labels,
+                      std::function<double(void)> read)
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->readings.push_back({name, help, "counter", labels, std::move(read)});
+}
+
+/******************************************************************************
+ * Write a histogram of durations in the Prometheus text format.
+ *
+ * @param out
+ * @param name Name of the metric.
+ * @param labels Labels of the histogram, followed by a comma, or an empty
+ *     string.
+ * @param histogram
+ *****************************************************************************/
+static void expose_histogram(std::ostream& out, char const* name, std::string const& labels,
+                             Histogram const& histogram)
+{
+    for(int exponent = EXPOSED_MIN_EXPONENT; exponent <= EXPOSED_MAX_EXPONENT; ++exponent)
+    {
+        std::size_t bucket = Histogram::bucket((std::uint64_t(1) << exponent) - 1);
+        out << name << "_bucket{" << labels << "le=\"" << std::ldexp(1e-9, exponent) << "\"} "
+            << histogram.count_below(bucket) << "\n";
+    }
+    out << name << "_bucket{" << labels << "le=\"+Inf\"} " << histogram.count() << "\n";
+    std::string plain_labels = labels.empty() ? "" : "{" + labels.substr(0, labels.size() - 1) + "}";
+    out << name << "_sum" << plain_labels << " " << histogram.total_value() * 1e-9 << "\n";
+    out << name << "_count" << plain_labels << " " << histogram.count() << "\n";
+}
+
+/******************************************************************************
+ * Add up the shards. The caller must hold the lock.
+ *
+ * @param total Shard to add them to.
+ *****************************************************************************/
+void Metrics::add_up(Shard& total)
+{
+    for(auto const& shard: this->shards)
+    {
+        for(int i = 0; i < 4; ++i)
+        {
+            for(int j = 0; j < 5; ++j)
+            {
+                total.construction[i][j].merge(shard->construction[i][j]);
+            }
+        }
+        total.evaluation.merge(shard->evaluation);
+        for(int i = 0; i < 3; ++i)
+        {
+            increment(total.requests[i], shard->requests[i].load(std::memory_order_relaxed));
+        }
+        increment(total.points, shard->points.load(std::memory_order_relaxed));
+        increment(total.queries, shard->queries.load(std::memory_order_relaxed));
+    }
+}
+
+/******************************************************************************
+ * Add up the shards and read the values kept elsewhere.
+ *
+ * @return Metrics in the Prometheus text format.
+ *****************************************************************************/
+std::string Metrics::expose(void)
+{
+    Shard total;
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->add_up(total);
+
+    std::ostringstream out;
+    out.precision(9);
+    out << "# HELP lagrange_requests_total Sets of points processed.\n";
+    out << "# TYPE lagrange_requests_total counter\n";
+    char const* outcomes[] = {"succeeded", "failed", "timed_out"};
+    for(int i = 0; i < 3; ++i)
+    {
+        out << "lagrange_requests_total{outcome=\"" << outcomes[i] << "\"} "
+            << total.requests[i].load(std::memory_order_relaxed) << "\n";
+    }
+    out << "# HELP lagrange_points_total Points interpolated.\n";
+    out << "# TYPE lagrange_points_total counter\n";
+    out << "lagrange_points_total " << total.points.load(std::memory_order_relaxed) << "\n";
+    out << "# HELP lagrange_queries_total x-coordinates evaluated at.\n";
+    out << "# TYPE lagrange_queries_total counter\n";
+    out << "lagrange_queries_total " << total.queries.load(std::memory_order_relaxed) << "\n";
+    out << "# HELP lagrange_construction_seconds Time taken to construct interpolating polynomials.\n";
+    out << "# TYPE lagrange_construction_seconds histogram\n";
+    // Those of the arithmetic other than `double` appear once used.
+    for(int i = 0; i < 4; ++i)
+    {
+        for(int j = 0; j < 5; ++j)
+        {
+            if(i > 0 && total.construction[i][j].count() == 0)
+            {
+                continue;
+            }
+            expose_histogram(out, "lagrange_construction_seconds",
+                             std::string("algorithm=\"") + construction_names[j] + "\",arithmetic=\""
+                                 + arithmetic_names[i] + "\",",
+                             total.construction[i][j]);
+        }
+    }
+    out << "# HELP lagrange_evaluation_seconds Time taken to evaluate interpolating polynomials.\n";
+    out << "# TYPE lagrange_evaluation_seconds histogram\n";
+    expose_histogram(out, "lagrange_evaluation_seconds", "", total.evaluation);
+
+    for(std::size_t i = 0; i < this->readings.size(); ++i)
+    {
+        Reading const& reading = this->readings[i];
+        if(i == 0 || this->readings[i - 1].name != reading.name)
+        {
+            out << "# HELP " << reading.name << " " << reading.help << "\n";
+            out << "# TYPE " << reading.name << " " << reading.type << "\n";
+        }
+        out << reading.name;
+        if(!reading.labels.empty())
+        {
+            out << "{" << reading.labels << "}";
+        }
+        out << " " << reading.read() << "\n";
+    }
+    return out.str();
+}
+
+/******************************************************************************
+ * Add up the shards into a dump which `merge` understands: the counters of
+ * requests by outcome, of points and of queries, followed by the histograms.
+ * The values kept elsewhere are not included.
+ *
+ * @return Dump.
+ *****************************************************************************/
+std::string Metrics::dump(void)
+{
+    Shard total;
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->add_up(total);
+    }
+    std::string out;
+    for(auto const& count: total.requests)
+    {
+        append(out, count.load(std::memory_order_relaxed));
+    }
+    append(out, total.points.load(std::memory_order_relaxed));
+    append(out, total.queries.load(std::memory_order_relaxed));
+    for(auto const& histograms: total.construction)
+    {
+        for(auto const& histogram: histograms)
+        {
+            histogram.dump(out);
+        }
+    }
+    total.evaluation.dump(out);
+    return out;
+}
+
+/******************************************************************************
+ * Add what another object recorded to the shard of the calling thread.
+ *
+ * @param dump Made by `dump`.
+ *
+ * @return `true` if the dump was added, `false` if it is malformed (in which
+ *     case nothing was).
+ *****************************************************************************/
+bool Metrics::merge(std::string const& dump)
+{
+    Shard other;
+    char const* position = dump.data();
+    char const* end = position + dump.size();
+    std::uint64_t counts[5];
+    for(auto& count: counts)
+    {
+        if(!extract(position, end, count))
+        {
+            return false;
+        }
+    }
+    for(auto& histograms: other.construction)
+    {
+        for(auto& histogram: histograms)
+        {
+            if(!histogram.load(position, end))
+            {
+                return false;
+            }
+        }
+    }
+    if(!other.evaluation.load(position, end) || position != end)
+    {
+        return false;
+    }
+
+    Shard& shard = this->local();
+    for(int i = 0; i < 4; ++i)
+    {
+        for(int j = 0; j < 5; ++j)
+        {
+            shard.construction[i][j].merge(other.construction[i][j]);
+        }
+    }
+    shard.evaluation.merge(other.evaluation);
+    for(int i = 0; i < 3; ++i)
+    {
+        increment(shard.requests[i], counts[i]);
+    }
+    increment(shard.points, counts[3]);
+    increment(shard.queries, counts[4]);
+    return true;
+}
+
+/******************************************************************************
+ * Write the metrics to a file. They are written to a temporary file first,
+ * which then replaces it, so that readers never see a partial file.
+ *
+ * @param path
+ *
+ * @return `true` if the file was written, else `false`.
+ *****************************************************************************/
+bool Metrics::write(char const* path)
+{
+    std::string contents = this->expose();
+    std::string temporary = std::string(path) + ".tmp";
+    std::FILE* file = std::fopen(temporary.c_str(), "w");
+    if(file == nullptr)
+    {
+        return false;
+    }
+    bool written = std::fwrite(contents.data(), 1, contents.size(), file) == contents.size();
+    written = std::fclose(file) == 0 && written;
+    return written && std::rename(temporary.c_str(), path) == 0;
+}
+
+/******************************************************************************
+ * Start a thread which writes the metrics to a file periodically, and once
+ * more when stopped.
+ *
+ * @param path
+ * @param interval
+ *****************************************************************************/
+void Metrics::publish(char const* path, std::chrono::steady_clock::duration interval)
+{
+    this->publisher = std::thread([this, path=std::string(path), interval]
+    {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        while(!this->stopped)
+        {
+            this->stopping.wait_for(lock, interval);
+            lock.unlock();
+            this->write(path.c_str());
+            lock.lock();
+        }
+    });
+}
+
+/******************************************************************************
+ * Stop writing the metrics periodically, after writing them once more.
+ *****************************************************************************/
+void Metrics::stop(void)
+{
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->stopped = true;
+    }
+    this->stopping.notify_all();
+    if(this->publisher.joinable())
+    {
+        this->publisher.join();
+    }
+}
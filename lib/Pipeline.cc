@@ -0,0 +1,372 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+#include "Budget.hh"
+#include "Cancellation.hh"
+#include "Input.hh"
+#include "Metrics.hh"
+#include "Pipeline.hh"
+#include "Polynomial.hh"
+#include "Processing.hh"
+#include "Queue.hh"
+#include "Scheduler.hh"
+
+// Accumulates the time a stage of the batch pipeline spends working, as
+// opposed to waiting on its queues.
+struct Stopwatch
+{
+    std::chrono::steady_clock::time_point begin;
+    std::chrono::steady_clock::duration busy{};
+
+    void start(void)
+    {
+        this->begin = std::chrono::steady_clock::now();
+    }
+    void stop(void)
+    {
+        this->busy += std::chrono::steady_clock::now() - this->begin;
+    }
+};
+
+// Set of points travelling through the batch pipeline. Those after the last
+// set tell the threads receiving them to stop.
+struct Job
+{
+    std::size_t index = 0;
+    char const* path = nullptr;
+    std::size_t set = 0;
+    Points points;
+    Estimate estimate;
+    std::string output, errors;
+    int status = EXIT_SUCCESS;
+    bool last = false;
+};
+
+/******************************************************************************
+ * Process several sets of points sharing the same x-coordinates together (see
+ * `interpolate_many`), then write out their results separately. If the memory
+ * they need together could never be available, or if anything other than the
+ * timeout expiring goes wrong, they are processed one at a time instead, so
+ * that each reports its own errors.
+ *
+ * @param group Sets of points. Those which have already failed are skipped.
+ * @param options
+ * @param budget
+ *
+ * @return `true` if the sets were processed together, else `false`.
+ *****************************************************************************/
+static bool process_group(std::vector<Job>& group, Options const& options, Budget& budget)
+{
+    auto finish = [&](Job& job, Polynomial* polynomial, std::chrono::steady_clock::duration delay)
+    {
+        std::ostringstream out, err;
+        out.precision(12);
+        if(polynomial != nullptr)
+        {
+            job.status = process(job.points, options, out, err, polynomial, delay);
+        }
+        else
+        {
+            job.status = admit(job.points, job.estimate.memory, job.set, options, budget, out, err);
+        }
+        job.output = out.str();
+        job.errors = err.str();
+    };
+
+    std::size_t memory = 0;
+    for(auto const& job: group)
+    {
+        memory += job.estimate.memory;
+    }
+    // Checking the capacity first avoids counting a rejection when the sets
+    // can still be processed one at a time.
+    if(group.size() > 1 && !options.extended && options.precision == 0 && memory <= budget.capacity()
+       && budget.acquire(memory))
+    {
+        std::vector<Polynomial> polynomials;
+        std::chrono::steady_clock::duration delay{};
+        try
+        {
+            std::vector<std::vector<double>> ycoords;
+            for(auto const& job: group)
+            {
+                ycoords.push_back(job.points.ycoords);
+            }
+            std::unique_ptr<Cancellation> cancellation = std::make_unique<Cancellation>();
+            if(options.timeout > 0)
+            {
+                cancellation = std::make_unique<Cancellation>(to_duration(options.timeout));
+            }
+            auto begin = std::chrono::steady_clock::now();
+            polynomials = options.y_only
+                          ? interpolate_many(options.start, options.step, ycoords, cancellation.get())
+                          : interpolate_many(group[0].points.xcoords, ycoords, Precision::standard,
+                                             cancellation.get());
+            delay = (std::chrono::steady_clock::now() - begin) / group.size();
+        }
+        catch(Expired const& e)
+        {
+            // Retrying one at a time would take up to as many timeouts as
+            // there are sets.
+            budget.release(memory);
+            for(auto& job: group)
+            {
+                std::ostringstream err;
+                err << "Gave up after " << options.timeout << " s. " << e.what() << "\n";
+                job.status = EXIT_TIMEOUT;
+                job.errors = err.str();
+                if(metrics != nullptr)
+                {
+                    metrics->record(Metrics::timed_out);
+                }
+            }
+            return true;
+        }
+        catch(std::exception const&)
+        {
+            polynomials.clear();
+        }
+        for(std::size_t i = 0; i < polynomials.size(); ++i)
+        {
+            finish(group[i], &polynomials[i], delay);
+        }
+        budget.release(memory);
+        if(!polynomials.empty())
+        {
+            return true;
+        }
+    }
+    for(auto& job: group)
+    {
+        if(job.status == EXIT_SUCCESS)
+        {
+            finish(job, nullptr, {});
+        }
+    }
+    return false;
+}
+
+/******************************************************************************
+ * Process the sets of points in several files using a pipeline of three
+ * stages: a reader thread, which reads the files, splits them into sets and
+ * parses them; a pool of compute threads; and a writer (this thread). Each
+ * stage works while the others do, so that no thread waits for input or
+ * output unless a queue is full or empty. The fraction of time each stage
+ * spent working is displayed at the end.
+ *
+ * The compute threads take the set predicted to be the cheapest first (see
+ * `Scheduler`), so that a few large sets do not hold up many small ones. The
+ * writer writes the results either in the order of the input, each file
+ * introduced by its name as `head(1)` does, or in the order they are ready,
+ * each introduced by the name of its file and its number in the file.
+ *
+ * @param paths Input files. `-` is standard input.
+ * @param options
+ * @param pipeline
+ * @param budget Memory available to the compute threads.
+ *
+ * @return Exit status.
+ *****************************************************************************/
+int batch(std::vector<char const*> const& paths, Options const& options, Pipeline const& pipeline, Budget& budget)
+{
+    std::size_t num_of_threads = pipeline.num_of_threads;
+    Scheduler<Job> inputs(pipeline.depth, pipeline.aging);
+    Queue<Job> outputs(pipeline.depth);
+    std::vector<Stopwatch> stopwatches(num_of_threads + 2);
+    Stopwatch& reader_stopwatch = stopwatches.front();
+    Stopwatch& writer_stopwatch = stopwatches.back();
+    auto begin = std::chrono::steady_clock::now();
+
+    // Sets waiting which share the x-coordinates of the one about to be
+    // computed are computed with it.
+    std::atomic<std::size_t> num_of_groups(0), num_of_coalesced(0);
+    if(metrics != nullptr)
+    {
+        metrics->gauge("lagrange_queue_depth", "Sets of points waiting between stages.", "queue=\"input\"",
+                       [&]{ return inputs.size(); });
+        metrics->gauge("lagrange_queue_depth", "Sets of points waiting between stages.", "queue=\"output\"",
+                       [&]{ return outputs.size(); });
+        metrics->gauge("lagrange_memory_reserved_bytes", "Memory reserved for sets of points being computed.", "",
+                       [&]{ return budget.usage(); });
+        metrics->counter("lagrange_coalesced_sets_total",
+                         "Sets of points computed together with others sharing their x-coordinates.", "",
+                         [&]{ return num_of_coalesced.load(); });
+    }
+
+    std::thread reader([&]
+    {
+        std::size_t index = 0;
+        for(auto const& path: paths)
+        {
+            reader_stopwatch.start();
+            std::unique_ptr<Stream> stream;
+            std::string contents;
+            if(std::string(path) == "-")
+            {
+                stream = std::make_unique<Stream>(STDIN_FILENO);
+            }
+            else if(read_file(path, contents))
+            {
+                stream = std::make_unique<Stream>(std::move(contents));
+            }
+            Job job;
+            job.path = path;
+            try
+            {
+                char const* set_begin;
+                char const* set_end;
+                for(job.set = 1; stream != nullptr && stream->next(set_begin, set_end); ++job.set)
+                {
+                    Job set_job;
+                    set_job.index = index++;
+                    set_job.path = path;
+                    set_job.set = job.set;
+                    std::ostringstream err;
+                    set_job.status = parse_set(set_begin, set_end, set_job.set, options, set_job.points, err);
+                    set_job.errors = err.str();
+                    set_job.estimate = estimate(set_job.points, options);
+                    double cost = set_job.estimate.cost;
+                    reader_stopwatch.stop();
+                    inputs.push(std::move(set_job), cost);
+                    reader_stopwatch.start();
+                }
+            }
+            catch(std::runtime_error const& e)
+            {
+                job.errors = std::string(e.what()) + "\n";
+            }
+            if(stream == nullptr)
+            {
+                job.errors = "File " + std::string(path) + " could not be read.\n";
+            }
+            reader_stopwatch.stop();
+            if(!job.errors.empty())
+            {
+                job.index = index++;
+                job.status = EXIT_FAILURE;
+                inputs.push(std::move(job), 0);
+            }
+        }
+        for(std::size_t thread = 0; thread < num_of_threads; ++thread)
+        {
+            Job job;
+            job.last = true;
+            inputs.push(std::move(job), std::numeric_limits<double>::infinity());
+        }
+    });
+
+    auto compute = [&](Stopwatch& stopwatch)
+    {
+        std::vector<Job> group;
+        while(true)
+        {
+            Job job = inputs.pop();
+            if(job.last)
+            {
+                outputs.push(std::move(job));
+                return;
+            }
+            group.clear();
+            if(job.status == EXIT_SUCCESS && pipeline.coalesce > 1)
+            {
+                auto matches = [&](Job const& other)
+                {
+                    return !other.last && other.status == EXIT_SUCCESS
+                           && other.points.ycoords.size() == job.points.ycoords.size()
+                           && other.points.xcoords == job.points.xcoords;
+                };
+                inputs.take(matches, pipeline.coalesce - 1, pipeline.window, group);
+            }
+            group.insert(group.begin(), std::move(job));
+            stopwatch.start();
+            if(process_group(group, options, budget))
+            {
+                ++num_of_groups;
+                num_of_coalesced += group.size();
+            }
+            stopwatch.stop();
+            for(auto& member: group)
+            {
+                outputs.push(std::move(member));
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    for(std::size_t thread = 0; thread < num_of_threads; ++thread)
+    {
+        threads.emplace_back(compute, std::ref(stopwatches[thread + 1]));
+    }
+
+    // In order, results are held on to until their turn comes.
+    Writer writer;
+    writer.ordered = pipeline.ordered;
+    std::map<std::size_t, Job> pending;
+    std::size_t next = 0;
+    for(std::size_t running = num_of_threads; running > 0;)
+    {
+        Job job = outputs.pop();
+        writer_stopwatch.start();
+        if(job.last)
+        {
+            --running;
+        }
+        else
+        {
+            pending.emplace(pipeline.ordered ? job.index : next, std::move(job));
+        }
+        for(auto it = pending.begin(); it != pending.end() && it->first == next; it = pending.erase(it), ++next)
+        {
+            Job const& ready = it->second;
+            writer.write(ready.path, ready.set, ready.output, ready.errors, ready.status);
+        }
+        writer_stopwatch.stop();
+    }
+    reader.join();
+    for(auto& thread: threads)
+    {
+        thread.join();
+    }
+
+    auto elapsed = std::chrono::steady_clock::now() - begin;
+    auto utilisation = [&](std::size_t first, std::size_t last)
+    {
+        std::chrono::steady_clock::duration busy{};
+        for(std::size_t i = first; i < last; ++i)
+        {
+            busy += stopwatches[i].busy;
+        }
+        return 100.0 * busy.count() / elapsed.count() / (last - first);
+    };
+    std::cerr << std::fixed << std::setprecision(1) << "Utilisation: reader " << utilisation(0, 1)
+              << "%, compute " << utilisation(1, num_of_threads + 1) << "% (" << num_of_threads
+              << " threads), writer " << utilisation(num_of_threads + 1, num_of_threads + 2) << "%.\n";
+    if(num_of_groups > 0)
+    {
+        std::cerr << "Coalesced " << num_of_coalesced << " sets sharing x-coordinates into " << num_of_groups
+                  << " groups.\n";
+    }
+
+    // The values read by the metrics are about to be destroyed.
+    if(metrics != nullptr)
+    {
+        metrics->stop();
+    }
+    return writer.status;
+}
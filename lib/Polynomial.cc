@@ -4,12 +4,14 @@
 #include <initializer_list>
 #include <iostream>
 #include <iterator>
+#include <limits>
 #include <numeric>
 #include <stdexcept>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "Cancellation.hh"
 #include "Polynomial.hh"
 
 #define THROW(exception, message)  \
@@ -40,7 +42,7 @@ Polynomial::Polynomial()
  * @return A polynomial with the given coefficients.
  *****************************************************************************/
 Polynomial::Polynomial(std::initializer_list<double> const& list)
-: std::vector<double>(list)
+: BasicPolynomial<double>(list)
 {
     this->sanitise();
 }
@@ -55,25 +57,264 @@ Polynomial::Polynomial(std::initializer_list<double> const& list)
  * @return A polynomial with the given coefficients.
  *****************************************************************************/
 Polynomial::Polynomial(std::vector<double> const& vector)
-: std::vector<double>(vector)
+: BasicPolynomial<double>(vector)
 {
     this->sanitise();
 }
 
 /******************************************************************************
- * Constructor. Given the x- and y-coordinates of a set of points, find the
- * interpolating polynomial which passes through all of them. If the two
- * arguments are of different sizes, the extra coordinates present at the end
- * of the larger argument are ignored.
+ * Constructor. Round the coefficients of a polynomial to `double`. Small
+ * coefficients are kept rather than sanitised: they were found accurately,
+ * and may matter far from the origin.
+ *
+ * @param extended Polynomial whose coefficients are double-double numbers.
+ *
+ * @return The nearest polynomial with `double` coefficients.
+ *****************************************************************************/
+Polynomial::Polynomial(BasicPolynomial<DoubleDouble> const& extended)
+{
+    for(auto const& coefficient: extended)
+    {
+        this->push_back(coefficient.to_double());
+    }
+    this->trim();
+}
+
+/******************************************************************************
+ * Sum the Lagrange basis polynomials, each scaled by the corresponding
+ * y-coordinate. Each is multiplied out in place, one linear factor at a time,
+ * so that no temporary polynomials (whose small coefficients would be
+ * sanitised away) are formed.
  *
  * @param xcoords
  * @param ycoords
+ * @param num_of_points
+ * @param cancellation
  *
- * @return A polynomial passing through the given points.
+ * @return Interpolating polynomial.
  *****************************************************************************/
-Polynomial::Polynomial(std::vector<double> const& xcoords, std::vector<double> const& ycoords)
+static Polynomial lagrange(std::vector<double> const& xcoords, std::vector<double> const& ycoords,
+                           std::size_t num_of_points, Cancellation const* cancellation)
+{
+    Polynomial result;
+    result.assign(num_of_points, 0);
+    std::vector<double> basis;
+    basis.reserve(num_of_points);
+    for(std::size_t i = 0; i < num_of_points; ++i)
+    {
+        check(cancellation);
+        basis.assign(1, ycoords[i]);
+        for(std::size_t j = 0; j < num_of_points; ++j)
+        {
+            if(i == j)
+            {
+                continue;
+            }
+            double difference = xcoords[i] - xcoords[j];
+            basis.push_back(0);
+            for(std::size_t k = basis.size() - 1; k > 0; --k)
+            {
+                basis[k] = (basis[k - 1] - xcoords[j] * basis[k]) / difference;
+            }
+            basis[0] = -xcoords[j] * basis[0] / difference;
+        }
+        for(std::size_t k = 0; k < num_of_points; ++k)
+        {
+            result[k] += basis[k];
+        }
+    }
+    return result;
+}
+
+/******************************************************************************
+ * Expand a polynomial in Newton form in place.
+ *
+ * @param coefficients Coefficients of the Newton basis polynomials. Replaced
+ *     with the coefficients in the monomial basis.
+ * @param nodes Nodes of the Newton basis polynomials.
+ * @param cancellation
+ *****************************************************************************/
+static void expand_in_place(std::vector<double>& coefficients, std::vector<double> const& nodes,
+                            Cancellation const* cancellation)
+{
+    std::size_t size = coefficients.size();
+    for(std::size_t k = size - 1; k > 0; --k)
+    {
+        check(cancellation);
+        double node = nodes[k - 1];
+        for(std::size_t i = k - 1; i < size - 1; ++i)
+        {
+            coefficients[i] -= node * coefficients[i + 1];
+        }
+    }
+}
+
+/******************************************************************************
+ * Compute divided differences and expand the resultant Newton form in place,
+ * so that no temporary polynomials (whose small coefficients would be
+ * sanitised away) are formed.
+ *
+ * @param xcoords
+ * @param ycoords
+ * @param order Indices of the points in the order they must be used in.
+ * @param cancellation
+ *
+ * @return Interpolating polynomial.
+ *****************************************************************************/
+static Polynomial newton(std::vector<double> const& xcoords, std::vector<double> const& ycoords,
+                         std::vector<std::size_t> const& order, Cancellation const* cancellation)
+{
+    std::size_t num_of_points = order.size();
+    std::vector<double> nodes(num_of_points), coefficients(num_of_points);
+    for(std::size_t i = 0; i < num_of_points; ++i)
+    {
+        nodes[i] = xcoords[order[i]];
+        coefficients[i] = ycoords[order[i]];
+    }
+    for(std::size_t k = 1; k < num_of_points; ++k)
+    {
+        check(cancellation);
+        for(std::size_t i = num_of_points - 1; i >= k; --i)
+        {
+            coefficients[i] = (coefficients[i] - coefficients[i - 1]) / (nodes[i] - nodes[i - k]);
+        }
+    }
+    expand_in_place(coefficients, nodes, cancellation);
+    Polynomial result;
+    result.assign(coefficients.begin(), coefficients.end());
+    return result;
+}
+
+/******************************************************************************
+ * Order the points such that each x-coordinate maximises the product of its
+ * distances from the preceding ones (Leja ordering). Logarithms of the
+ * products are compared, so that they do not overflow.
+ *
+ * @param xcoords
+ * @param num_of_points
+ * @param cancellation
+ *
+ * @return Indices of the points in Leja order.
+ *****************************************************************************/
+static std::vector<std::size_t> leja(std::vector<double> const& xcoords, std::size_t num_of_points,
+                                     Cancellation const* cancellation)
+{
+    std::vector<std::size_t> order(num_of_points);
+    std::iota(order.begin(), order.end(), 0);
+    auto largest = std::max_element(order.begin(), order.end(), [&](std::size_t i, std::size_t j)
+    {
+        return std::abs(xcoords[i]) < std::abs(xcoords[j]);
+    });
+    std::iter_swap(order.begin(), largest);
+
+    std::vector<double> scores(num_of_points, 0);
+    for(std::size_t k = 1; k < num_of_points; ++k)
+    {
+        check(cancellation);
+        double previous = xcoords[order[k - 1]];
+        std::size_t best = k;
+        for(std::size_t i = k; i < num_of_points; ++i)
+        {
+            scores[order[i]] += std::log(std::abs(xcoords[order[i]] - previous));
+            if(scores[order[i]] > scores[order[best]])
+            {
+                best = i;
+            }
+        }
+        std::swap(order[k], order[best]);
+    }
+    return order;
+}
+
+/******************************************************************************
+ * Compute forward differences of the y-coordinates of equispaced points and
+ * expand the resultant Newton form in place. No x-coordinate differences are
+ * required, so that, if the y-coordinates are integers, all differences are
+ * exact. The x-coordinates themselves are generated as they are needed.
+ *
+ * @param start First x-coordinate.
+ * @param step Difference between consecutive x-coordinates.
+ * @param ycoords
+ * @param num_of_points
+ * @param cancellation
+ *
+ * @return Interpolating polynomial.
+ *****************************************************************************/
+static Polynomial forward_difference(double start, double step, std::vector<double> const& ycoords,
+                                     std::size_t num_of_points, Cancellation const* cancellation)
+{
+    Polynomial result;
+    result.assign(ycoords.begin(), ycoords.begin() + num_of_points);
+    for(std::size_t k = 1; k < num_of_points; ++k)
+    {
+        check(cancellation);
+        for(std::size_t i = num_of_points - 1; i >= k; --i)
+        {
+            result[i] -= result[i - 1];
+        }
+    }
+
+    // The kth forward difference must be divided by the factorial of k and
+    // the kth power of the step size.
+    double divisor = 1;
+    for(std::size_t k = 1; k < num_of_points; ++k)
+    {
+        divisor *= k * step;
+        result[k] /= divisor;
+    }
+
+    // Same as `expand_in_place`.
+    for(std::size_t k = num_of_points - 1; k > 0; --k)
+    {
+        check(cancellation);
+        double node = start + (k - 1) * step;
+        for(std::size_t i = k - 1; i < num_of_points - 1; ++i)
+        {
+            result[i] -= node * result[i + 1];
+        }
+    }
+    return result;
+}
+
+/******************************************************************************
+ * Solve the Vandermonde system for the coefficients using the Björck–Pereyra
+ * algorithm. The first stage overwrites the y-coordinates with divided
+ * differences; the second expands the Newton form in place. No temporary
+ * polynomials are created: the coefficients are the only storage used.
+ *
+ * @param xcoords
+ * @param ycoords
+ * @param num_of_points
+ * @param cancellation
+ *
+ * @return Interpolating polynomial.
+ *****************************************************************************/
+static Polynomial bjorck_pereyra(std::vector<double> const& xcoords, std::vector<double> const& ycoords,
+                                 std::size_t num_of_points, Cancellation const* cancellation)
+{
+    Polynomial result;
+    result.assign(ycoords.begin(), ycoords.begin() + num_of_points);
+    for(std::size_t k = 1; k < num_of_points; ++k)
+    {
+        check(cancellation);
+        for(std::size_t i = num_of_points - 1; i >= k; --i)
+        {
+            result[i] = (result[i] - result[i - 1]) / (xcoords[i] - xcoords[i - k]);
+        }
+    }
+    expand_in_place(result, xcoords, cancellation);
+    return result;
+}
+
+/******************************************************************************
+ * Check that there are enough points to interpolate, and that their
+ * x-coordinates are distinct.
+ *
+ * @param xcoords
+ * @param num_of_points
+ *****************************************************************************/
+static void validate(std::vector<double> const& xcoords, std::size_t num_of_points)
 {
-    std::size_t num_of_points = std::min(xcoords.size(), ycoords.size());
     if(num_of_points <= 1)
     {
         THROW(std::invalid_argument, "At least two points are required for interpolation.")
@@ -89,21 +330,657 @@ Polynomial::Polynomial(std::vector<double> const& xcoords, std::vector<double> c
         }
         ++unique_xcoords[xcoord];
     }
+}
+
+/******************************************************************************
+ * Constructor. Given the x- and y-coordinates of a set of points, find the
+ * interpolating polynomial which passes through all of them. If the two
+ * arguments are of different sizes, the extra coordinates present at the end
+ * of the larger argument are ignored. The algorithm used is chosen based on
+ * the number of points, the structure of the x-coordinates and the requested
+ * precision; see `select_construction`. With `Precision::extended`, it is
+ * `interpolate_extended`, and the result is rounded.
+ *
+ * @param xcoords
+ * @param ycoords
+ * @param precision
+ * @param cancellation Token polled periodically, or `nullptr`. If it expires,
+ *     `Expired` is thrown.
+ *
+ * @return A polynomial passing through the given points.
+ *****************************************************************************/
+Polynomial::Polynomial(std::vector<double> const& xcoords, std::vector<double> const& ycoords,
+                       Precision precision, Cancellation const* cancellation)
+{
+    std::size_t num_of_points = std::min(xcoords.size(), ycoords.size());
+    Polynomial result = precision == Precision::extended
+                        ? Polynomial(interpolate_extended(xcoords, ycoords, cancellation))
+                        : Polynomial(xcoords, ycoords,
+                                     select_construction(num_of_points, classify(xcoords, num_of_points), precision),
+                                     cancellation);
+    this->swap(result);
+}
+
+/******************************************************************************
+ * Find the interpolating polynomial passing through a set of points using the
+ * specified algorithm. Its coefficients are not sanitised.
+ *
+ * @param xcoords
+ * @param ycoords
+ * @param num_of_points
+ * @param construction
+ * @param cancellation
+ *
+ * @return Interpolating polynomial.
+ *****************************************************************************/
+static Polynomial construct(std::vector<double> const& xcoords, std::vector<double> const& ycoords,
+                            std::size_t num_of_points, Construction construction, Cancellation const* cancellation)
+{
+    Polynomial result;
+    switch(construction)
+    {
+        case Construction::lagrange:
+            result = lagrange(xcoords, ycoords, num_of_points, cancellation);
+            break;
+        case Construction::newton:
+        {
+            std::vector<std::size_t> order(num_of_points);
+            std::iota(order.begin(), order.end(), 0);
+            result = newton(xcoords, ycoords, order, cancellation);
+            break;
+        }
+        case Construction::newton_leja:
+            result = newton(xcoords, ycoords, leja(xcoords, num_of_points, cancellation), cancellation);
+            break;
+        case Construction::forward_difference:
+        {
+            double step = (xcoords[num_of_points - 1] - xcoords[0]) / (num_of_points - 1);
+            result = forward_difference(xcoords[0], step, ycoords, num_of_points, cancellation);
+            break;
+        }
+        case Construction::bjorck_pereyra:
+            result = bjorck_pereyra(xcoords, ycoords, num_of_points, cancellation);
+            break;
+    }
+    return result;
+}
+
+/******************************************************************************
+ * Constructor. Given the x- and y-coordinates of a set of points, find the
+ * interpolating polynomial which passes through all of them using the
+ * specified algorithm. If the two arguments are of different sizes, the extra
+ * coordinates present at the end of the larger argument are ignored.
+ *
+ * @param xcoords
+ * @param ycoords
+ * @param construction Algorithm. `Construction::forward_difference` must only
+ *     be used if the x-coordinates are equispaced.
+ * @param cancellation Token polled periodically, or `nullptr`. If it expires,
+ *     `Expired` is thrown.
+ *
+ * @return A polynomial passing through the given points.
+ *****************************************************************************/
+Polynomial::Polynomial(std::vector<double> const& xcoords, std::vector<double> const& ycoords,
+                       Construction construction, Cancellation const* cancellation)
+{
+    std::size_t num_of_points = std::min(xcoords.size(), ycoords.size());
+    validate(xcoords, num_of_points);
+
+    Polynomial result = construct(xcoords, ycoords, num_of_points, construction, cancellation);
+    this->swap(result);
+    this->sanitise();
+}
+
+/******************************************************************************
+ * Constructor. Given the y-coordinates of a set of points whose x-coordinates
+ * are equispaced, find the interpolating polynomial which passes through all
+ * of them. The x-coordinates are never stored.
+ *
+ * @param start First x-coordinate.
+ * @param step Difference between consecutive x-coordinates.
+ * @param ycoords
+ * @param cancellation Token polled periodically, or `nullptr`. If it expires,
+ *     `Expired` is thrown.
+ *
+ * @return A polynomial passing through the given points.
+ *****************************************************************************/
+Polynomial::Polynomial(double start, double step, std::vector<double> const& ycoords,
+                       Cancellation const* cancellation)
+{
+    std::size_t num_of_points = ycoords.size();
+    if(num_of_points <= 1)
+    {
+        THROW(std::invalid_argument, "At least two points are required for interpolation.")
+    }
+    if(step == 0 || !std::isfinite(step) || !std::isfinite(start))
+    {
+        std::string message = "Expected a finite, non-zero step size, but got " + std::to_string(step) + ".";
+        THROW(std::invalid_argument, message)
+    }
+    Polynomial result = forward_difference(start, step, ycoords, num_of_points, cancellation);
+    this->swap(result);
+    this->sanitise();
+}
+
+/******************************************************************************
+ * Given the x- and y-coordinates of a set of points, find the interpolating
+ * polynomial which passes through all of them using double-double arithmetic:
+ * divided differences of the points in Leja order, and the expansion of the
+ * resultant Newton form. If the two arguments are of different sizes, the
+ * extra coordinates present at the end of the larger argument are ignored.
+ *
+ * @param xcoords
+ * @param ycoords
+ * @param cancellation Token polled periodically, or `nullptr`. If it expires,
+ *     `Expired` is thrown.
+ *
+ * @return Interpolating polynomial, with double-double coefficients.
+ *****************************************************************************/
+BasicPolynomial<DoubleDouble> interpolate_extended(std::vector<double> const& xcoords,
+                                                   std::vector<double> const& ycoords,
+                                                   Cancellation const* cancellation)
+{
+    std::size_t num_of_points = std::min(xcoords.size(), ycoords.size());
+    validate(xcoords, num_of_points);
+    std::vector<DoubleDouble> nodes, values;
+    for(auto const& i: leja(xcoords, num_of_points, cancellation))
+    {
+        nodes.push_back(xcoords[i]);
+        values.push_back(ycoords[i]);
+    }
+    return BasicPolynomial<DoubleDouble>(nodes, values, cancellation);
+}
+
+/******************************************************************************
+ * Measure the accuracy lost by rounding the coefficients of a polynomial: the
+ * largest change in its values at some x-coordinates, relative to the largest
+ * of those values. Both polynomials are evaluated using double-double
+ * arithmetic, so that only the rounding is measured.
+ *
+ * @param extended Polynomial whose coefficients are double-double numbers.
+ * @param p The same polynomial, with its coefficients rounded.
+ * @param xcoords
+ *
+ * @return Relative error.
+ *****************************************************************************/
+double rounding_error(BasicPolynomial<DoubleDouble> const& extended, Polynomial const& p,
+                      std::vector<double> const& xcoords)
+{
+    BasicPolynomial<DoubleDouble> rounded(std::vector<DoubleDouble>(p.begin(), p.end()));
+    double largest_value = 0, largest_error = 0;
+    for(auto const& xcoord: xcoords)
+    {
+        DoubleDouble value = extended(xcoord);
+        largest_value = std::max(largest_value, std::abs(value.to_double()));
+        largest_error = std::max(largest_error, std::abs((value - rounded(xcoord)).to_double()));
+    }
+    return largest_value > 0 ? largest_error / largest_value : largest_error;
+}
+
+/******************************************************************************
+ * Evaluate a polynomial using the compensated Horner method: the rounding
+ * errors of each step are found exactly, and accumulated by a second Horner
+ * recurrence. The result is as accurate as if it had been computed with twice
+ * the precision.
+ *
+ * @param p
+ * @param x
+ *
+ * @return Value of `p` at `x`, with its correction.
+ *****************************************************************************/
+static DoubleDouble compensated_horner(Polynomial const& p, double x)
+{
+    double value = 0, error = 0;
+    for(auto it = p.crbegin(); it != p.crend(); ++it)
+    {
+        double product = value * x;
+        double product_error = std::fma(value, x, -product);
+        double sum = product + *it;
+        double addend_virtual = sum - product;
+        double sum_error = (product - (sum - addend_virtual)) + (*it - addend_virtual);
+        value = sum;
+        error = error * x + (product_error + sum_error);
+    }
+    return DoubleDouble(value, error);
+}
+
+/******************************************************************************
+ * Find the differences between the y-coordinates of some points and the
+ * values of a polynomial at their x-coordinates, evaluated using the
+ * compensated Horner method, so that the differences are accurate even when
+ * they are far smaller than the y-coordinates.
+ *
+ * @param p
+ * @param xcoords
+ * @param ycoords
+ * @param residuals Array to write the differences to.
+ *
+ * @return Largest difference, in magnitude.
+ *****************************************************************************/
+static double find_residuals(Polynomial const& p, std::vector<double> const& xcoords,
+                             std::vector<double> const& ycoords, std::vector<double>& residuals)
+{
+    double largest_residual = 0;
+    for(std::size_t i = 0; i < residuals.size(); ++i)
+    {
+        residuals[i] = (DoubleDouble(ycoords[i]) - compensated_horner(p, xcoords[i])).to_double();
+        largest_residual = std::max(largest_residual, std::abs(residuals[i]));
+    }
+    return largest_residual;
+}
+
+/******************************************************************************
+ * Measure how far this polynomial is from passing through a set of points.
+ *
+ * @param xcoords
+ * @param ycoords
+ *
+ * @return Largest difference between a y-coordinate and the value at the
+ *     corresponding x-coordinate, relative to the largest y-coordinate.
+ *****************************************************************************/
+double Polynomial::residual(std::vector<double> const& xcoords, std::vector<double> const& ycoords) const
+{
+    std::vector<double> residuals(std::min(xcoords.size(), ycoords.size()));
+    double largest_residual = find_residuals(*this, xcoords, ycoords, residuals);
+    double largest_ycoord = 0;
+    for(std::size_t i = 0; i < residuals.size(); ++i)
+    {
+        largest_ycoord = std::max(largest_ycoord, std::abs(ycoords[i]));
+    }
+    return largest_ycoord > 0 ? largest_residual / largest_ycoord : largest_residual;
+}
 
-    // Calculate using the formula for the Lagrange interpolating polynomial.
+/******************************************************************************
+ * Improve this polynomial, which interpolates a set of points, by iterative
+ * refinement: find the residuals at the points, interpolate them using
+ * forward differences if the x-coordinates are equispaced, else the Newton
+ * form of the points in Leja order (the algorithms `select_construction`
+ * chooses for `Precision::high`, whichever constructed the polynomial, and
+ * without sanitising the coefficients of the correction), and add the result.
+ * Each iteration takes about as long as constructing the polynomial with
+ * those algorithms does. Refinement stops once the residuals are no
+ * larger than the unit roundoff (relative to the largest y-coordinate), or
+ * when an iteration fails to reduce them, in which case it is undone; so it
+ * cannot help if evaluating the polynomial at the points is itself
+ * inaccurate.
+ *
+ * @param xcoords
+ * @param ycoords
+ * @param max_iterations
+ * @param cancellation Token polled periodically, or `nullptr`. If it expires,
+ *     `Expired` is thrown.
+ *
+ * @return Number of iterations which reduced the residuals.
+ *****************************************************************************/
+std::size_t Polynomial::refine(std::vector<double> const& xcoords, std::vector<double> const& ycoords,
+                               std::size_t max_iterations, Cancellation const* cancellation)
+{
+    std::size_t num_of_points = std::min(xcoords.size(), ycoords.size());
+    std::vector<double> residuals(num_of_points);
+    double largest_residual = find_residuals(*this, xcoords, ycoords, residuals);
+    double largest_ycoord = 0;
     for(std::size_t i = 0; i < num_of_points; ++i)
     {
-        Polynomial local = {ycoords[i]};
-        for(std::size_t j = 0; j < num_of_points; ++j)
+        largest_ycoord = std::max(largest_ycoord, std::abs(ycoords[i]));
+    }
+    double const tolerance = std::numeric_limits<double>::epsilon() / 2 * largest_ycoord;
+    Construction construction = select_construction(num_of_points, classify(xcoords, num_of_points), Precision::high);
+
+    std::size_t iterations = 0;
+    for(; iterations < max_iterations && largest_residual > tolerance; ++iterations)
+    {
+        // Scale the residuals by a power of 2 (exactly) to the size of the
+        // y-coordinates, so that the coefficients of the correction are not
+        // mistaken for rounding errors and removed.
+        int scale = largest_ycoord > 0 ? std::ilogb(largest_ycoord) - std::ilogb(largest_residual) : 0;
+        for(auto& residual: residuals)
+        {
+            residual = std::ldexp(residual, scale);
+        }
+        Polynomial correction = construct(xcoords, residuals, num_of_points, construction, cancellation);
+
+        Polynomial previous = *this;
+        if(this->size() < correction.size())
+        {
+            this->resize(correction.size(), 0);
+        }
+        for(std::size_t i = 0; i < correction.size(); ++i)
+        {
+            (*this)[i] += std::ldexp(correction[i], -scale);
+        }
+        this->trim();
+        double next_residual = find_residuals(*this, xcoords, ycoords, residuals);
+        if(!(next_residual < largest_residual))
+        {
+            this->swap(previous);
+            break;
+        }
+        largest_residual = next_residual;
+    }
+    return iterations;
+}
+
+/******************************************************************************
+ * Take the y-coordinates of several sets of points sharing the same
+ * x-coordinates as a block, with the ith y-coordinates of all sets in the ith
+ * row, so that the loops over the sets are innermost and contiguous.
+ *
+ * @param ycoords
+ * @param num_of_points Number of points in each set.
+ *
+ * @return Block.
+ *****************************************************************************/
+static std::vector<double> to_block(std::vector<std::vector<double>> const& ycoords, std::size_t num_of_points)
+{
+    std::size_t num_of_sets = ycoords.size();
+    std::vector<double> block(num_of_points * num_of_sets);
+    for(std::size_t j = 0; j < num_of_sets; ++j)
+    {
+        if(ycoords[j].size() != num_of_points)
         {
-            if(i != j)
+            std::string message = "Expected " + std::to_string(num_of_points) + " y-coordinates in every set, but set "
+                                  + std::to_string(j) + " has " + std::to_string(ycoords[j].size()) + ".";
+            THROW(std::invalid_argument, message)
+        }
+        for(std::size_t i = 0; i < num_of_points; ++i)
+        {
+            block[i * num_of_sets + j] = ycoords[j][i];
+        }
+    }
+    return block;
+}
+
+/******************************************************************************
+ * Split a block of coefficients (one set per column) into polynomials.
+ *
+ * @param block
+ * @param num_of_points Number of rows.
+ * @param num_of_sets Number of columns.
+ *
+ * @return Polynomials.
+ *****************************************************************************/
+static std::vector<Polynomial> from_block(std::vector<double> const& block, std::size_t num_of_points,
+                                          std::size_t num_of_sets)
+{
+    std::vector<Polynomial> results(num_of_sets);
+    for(std::size_t j = 0; j < num_of_sets; ++j)
+    {
+        results[j].resize(num_of_points);
+        for(std::size_t i = 0; i < num_of_points; ++i)
+        {
+            results[j][i] = block[i * num_of_sets + j];
+        }
+    }
+    return results;
+}
+
+/******************************************************************************
+ * Same as `expand_in_place`, for every column of a block.
+ *
+ * @param block
+ * @param num_of_points Number of rows.
+ * @param num_of_sets Number of columns.
+ * @param node_at Function giving the kth node of the Newton basis.
+ * @param cancellation
+ *****************************************************************************/
+template<typename NodeAt>
+static void expand_block(std::vector<double>& block, std::size_t num_of_points, std::size_t num_of_sets,
+                         NodeAt node_at, Cancellation const* cancellation)
+{
+    for(std::size_t k = num_of_points - 1; k > 0; --k)
+    {
+        check(cancellation);
+        double node = node_at(k - 1);
+        for(std::size_t i = k - 1; i < num_of_points - 1; ++i)
+        {
+            double* row = block.data() + i * num_of_sets;
+            double const* next = row + num_of_sets;
+            #pragma omp simd
+            for(std::size_t j = 0; j < num_of_sets; ++j)
             {
-                local *= Polynomial({-xcoords[j], 1}) / (-xcoords[j] + xcoords[i]);
+                row[j] -= node * next[j];
             }
         }
-        *this += local;
     }
-    this->sanitise();
+}
+
+/******************************************************************************
+ * Same as `forward_difference`, for every column of a block.
+ *
+ * @param start
+ * @param step
+ * @param block
+ * @param num_of_points Number of rows.
+ * @param num_of_sets Number of columns.
+ * @param cancellation
+ *****************************************************************************/
+static void forward_difference_block(double start, double step, std::vector<double>& block,
+                                     std::size_t num_of_points, std::size_t num_of_sets,
+                                     Cancellation const* cancellation)
+{
+    for(std::size_t k = 1; k < num_of_points; ++k)
+    {
+        check(cancellation);
+        for(std::size_t i = num_of_points - 1; i >= k; --i)
+        {
+            double* row = block.data() + i * num_of_sets;
+            double const* previous = row - num_of_sets;
+            #pragma omp simd
+            for(std::size_t j = 0; j < num_of_sets; ++j)
+            {
+                row[j] -= previous[j];
+            }
+        }
+    }
+    double divisor = 1;
+    for(std::size_t k = 1; k < num_of_points; ++k)
+    {
+        divisor *= k * step;
+        double* row = block.data() + k * num_of_sets;
+        for(std::size_t j = 0; j < num_of_sets; ++j)
+        {
+            row[j] /= divisor;
+        }
+    }
+    expand_block(block, num_of_points, num_of_sets, [&](std::size_t k){ return start + k * step; }, cancellation);
+}
+
+/******************************************************************************
+ * Compute divided differences in place for every column of a block, with the
+ * points taken in the given order. Each difference of x-coordinates is
+ * computed once for all columns.
+ *
+ * @param nodes x-coordinates, in the order the points must be used in.
+ * @param block Rows in the same order as `nodes`.
+ * @param num_of_sets Number of columns.
+ * @param cancellation
+ *****************************************************************************/
+static void divided_differences_block(std::vector<double> const& nodes, std::vector<double>& block,
+                                      std::size_t num_of_sets, Cancellation const* cancellation)
+{
+    std::size_t num_of_points = nodes.size();
+    for(std::size_t k = 1; k < num_of_points; ++k)
+    {
+        check(cancellation);
+        for(std::size_t i = num_of_points - 1; i >= k; --i)
+        {
+            double difference = nodes[i] - nodes[i - k];
+            double* row = block.data() + i * num_of_sets;
+            double const* previous = row - num_of_sets;
+            #pragma omp simd
+            for(std::size_t j = 0; j < num_of_sets; ++j)
+            {
+                row[j] = (row[j] - previous[j]) / difference;
+            }
+        }
+    }
+}
+
+/******************************************************************************
+ * Find the interpolating polynomials of several sets of points which share
+ * the same x-coordinates. Everything which depends only on the x-coordinates
+ * (checking them, choosing the algorithm, ordering them, and computing their
+ * differences, the Lagrange basis polynomials and the Newton basis
+ * polynomials) is done once, and the rest is done for all sets together. The
+ * results are the same as those of constructing the polynomials one at a time,
+ * except that the Lagrange basis polynomials are scaled by the y-coordinates
+ * after being formed rather than before, which may round differently.
+ *
+ * @param xcoords
+ * @param ycoords y-coordinates of each set. There must be as many in each set
+ *     as there are x-coordinates.
+ * @param precision
+ * @param cancellation Token polled periodically, or `nullptr`. If it expires,
+ *     `Expired` is thrown.
+ *
+ * @return Polynomials passing through each set of points.
+ *****************************************************************************/
+std::vector<Polynomial> interpolate_many(std::vector<double> const& xcoords,
+                                         std::vector<std::vector<double>> const& ycoords, Precision precision,
+                                         Cancellation const* cancellation)
+{
+    std::size_t num_of_points = xcoords.size();
+    std::size_t num_of_sets = ycoords.size();
+    validate(xcoords, num_of_points);
+    std::vector<Polynomial> results(num_of_sets);
+    if(precision == Precision::extended)
+    {
+        for(std::size_t set = 0; set < num_of_sets; ++set)
+        {
+            results[set] = Polynomial(interpolate_extended(xcoords, ycoords[set], cancellation));
+        }
+        return results;
+    }
+    std::vector<double> block = to_block(ycoords, num_of_points);
+    Construction construction = select_construction(num_of_points, classify(xcoords, num_of_points), precision);
+    switch(construction)
+    {
+        case Construction::lagrange:
+        {
+            // Each Lagrange basis polynomial is formed once and scaled by the
+            // y-coordinate of each set. Its coefficients are sanitised only
+            // after scaling, since they may be small while the products are
+            // not.
+            Polynomial basis, local;
+            for(std::size_t i = 0; i < num_of_points; ++i)
+            {
+                check(cancellation);
+                basis.assign(1, 1);
+                for(std::size_t j = 0; j < num_of_points; ++j)
+                {
+                    if(i == j)
+                    {
+                        continue;
+                    }
+                    double difference = -xcoords[j] + xcoords[i];
+                    basis.push_back(0);
+                    for(std::size_t k = basis.size() - 1; k > 0; --k)
+                    {
+                        basis[k] = (basis[k - 1] - xcoords[j] * basis[k]) / difference;
+                    }
+                    basis[0] = -xcoords[j] * basis[0] / difference;
+                }
+                for(std::size_t set = 0; set < num_of_sets; ++set)
+                {
+                    local.assign(basis.begin(), basis.end());
+                    local *= block[i * num_of_sets + set];
+                    results[set] += local;
+                }
+            }
+            break;
+        }
+        case Construction::newton:
+        case Construction::newton_leja:
+        {
+            std::vector<std::size_t> order(num_of_points);
+            std::iota(order.begin(), order.end(), 0);
+            if(construction == Construction::newton_leja)
+            {
+                order = leja(xcoords, num_of_points, cancellation);
+            }
+            std::vector<double> nodes(num_of_points), ordered(block.size());
+            for(std::size_t i = 0; i < num_of_points; ++i)
+            {
+                nodes[i] = xcoords[order[i]];
+                std::copy_n(block.begin() + order[i] * num_of_sets, num_of_sets, ordered.begin() + i * num_of_sets);
+            }
+            divided_differences_block(nodes, ordered, num_of_sets, cancellation);
+
+            // Same as `expand`, with each Newton basis polynomial formed once.
+            Polynomial basis = {1};
+            for(std::size_t k = 0; k < num_of_points; ++k)
+            {
+                check(cancellation);
+                for(std::size_t set = 0; set < num_of_sets; ++set)
+                {
+                    results[set] += basis * ordered[k * num_of_sets + set];
+                }
+                if(k + 1 < num_of_points)
+                {
+                    basis *= Polynomial({-nodes[k], 1});
+                }
+            }
+            break;
+        }
+        case Construction::forward_difference:
+        {
+            double step = (xcoords[num_of_points - 1] - xcoords[0]) / (num_of_points - 1);
+            forward_difference_block(xcoords[0], step, block, num_of_points, num_of_sets, cancellation);
+            results = from_block(block, num_of_points, num_of_sets);
+            break;
+        }
+        case Construction::bjorck_pereyra:
+            divided_differences_block(xcoords, block, num_of_sets, cancellation);
+            expand_block(block, num_of_points, num_of_sets, [&](std::size_t k){ return xcoords[k]; }, cancellation);
+            results = from_block(block, num_of_points, num_of_sets);
+            break;
+    }
+    for(auto& result: results)
+    {
+        result.sanitise();
+    }
+    return results;
+}
+
+/******************************************************************************
+ * Find the interpolating polynomials of several sets of points which share
+ * the same equispaced x-coordinates, given only their y-coordinates. See the
+ * constructor taking the same arguments for a single set.
+ *
+ * @param start First x-coordinate.
+ * @param step Difference between consecutive x-coordinates.
+ * @param ycoords y-coordinates of each set. There must be as many in each set.
+ * @param cancellation Token polled periodically, or `nullptr`. If it expires,
+ *     `Expired` is thrown.
+ *
+ * @return Polynomials passing through each set of points.
+ *****************************************************************************/
+std::vector<Polynomial> interpolate_many(double start, double step, std::vector<std::vector<double>> const& ycoords,
+                                         Cancellation const* cancellation)
+{
+    std::size_t num_of_sets = ycoords.size();
+    if(num_of_sets == 0)
+    {
+        return {};
+    }
+    std::size_t num_of_points = ycoords[0].size();
+    if(num_of_points <= 1)
+    {
+        THROW(std::invalid_argument, "At least two points are required for interpolation.")
+    }
+    if(step == 0 || !std::isfinite(step) || !std::isfinite(start))
+    {
+        std::string message = "Expected a finite, non-zero step size, but got " + std::to_string(step) + ".";
+        THROW(std::invalid_argument, message)
+    }
+    std::vector<double> block = to_block(ycoords, num_of_points);
+    forward_difference_block(start, step, block, num_of_points, num_of_sets, cancellation);
+    std::vector<Polynomial> results = from_block(block, num_of_points, num_of_sets);
+    for(auto& result: results)
+    {
+        result.sanitise();
+    }
+    return results;
 }
 
 /******************************************************************************
@@ -140,18 +1017,18 @@ std::ostream& operator<<(std::ostream& ostream, Polynomial const& p)
     ostream << "[";
     for(auto const& coefficient: p)
     {
-        std::cout << delimiter;
+        ostream << delimiter;
         if(p.rational)
         {
-            std::cout << rationalise(coefficient);
+            ostream << rationalise(coefficient);
         }
         else
         {
-            std::cout << coefficient;
+            ostream << coefficient;
         }
         delimiter = actual_delimiter;
     }
-    std::cout << "]";
+    ostream << "]";
     return ostream;
 }
 
@@ -243,7 +1120,74 @@ void operator*=(Polynomial& p, Polynomial const& q)
 }
 
 /******************************************************************************
- * Multiply two polynomials.
+ * Multiply two sequences, adding the result to the output sequence.
+ *
+ * @param p First sequence.
+ * @param p_size Length of the first sequence.
+ * @param q Second sequence.
+ * @param q_size Length of the second sequence.
+ * @param r Output sequence, of length `p_size + q_size - 1`.
+ *****************************************************************************/
+static void convolve(double const* p, std::size_t p_size, double const* q, std::size_t q_size, double* r)
+{
+    for(std::size_t i = 0; i < p_size; ++i)
+    {
+        for(std::size_t j = 0; j < q_size; ++j)
+        {
+            r[i + j] += p[i] * q[j];
+        }
+    }
+}
+
+/******************************************************************************
+ * Multiply two sequences of the same length using Karatsuba's algorithm,
+ * adding the result to the output sequence.
+ *
+ * @param p First sequence.
+ * @param q Second sequence.
+ * @param size Length of each sequence.
+ * @param r Output sequence, of length `2 * size - 1`.
+ *****************************************************************************/
+static void karatsuba(double const* p, double const* q, std::size_t size, double* r)
+{
+    if(select_multiplication(size, size) == Multiplication::schoolbook)
+    {
+        convolve(p, size, q, size, r);
+        return;
+    }
+
+    // Split each sequence into a low part and a (possibly longer) high part.
+    std::size_t low = size / 2;
+    std::size_t high = size - low;
+    std::vector<double> z0(2 * low - 1), z1(2 * high - 1), z2(2 * high - 1), p_sum(high), q_sum(high);
+    karatsuba(p, q, low, z0.data());
+    karatsuba(p + low, q + low, high, z2.data());
+    for(std::size_t i = 0; i < high; ++i)
+    {
+        p_sum[i] = p[low + i] + (i < low ? p[i] : 0);
+        q_sum[i] = q[low + i] + (i < low ? q[i] : 0);
+    }
+    karatsuba(p_sum.data(), q_sum.data(), high, z1.data());
+    for(std::size_t i = 0; i < z0.size(); ++i)
+    {
+        z1[i] -= z0[i];
+        r[i] += z0[i];
+    }
+    for(std::size_t i = 0; i < z2.size(); ++i)
+    {
+        z1[i] -= z2[i];
+        r[2 * low + i] += z2[i];
+    }
+    for(std::size_t i = 0; i < z1.size(); ++i)
+    {
+        r[low + i] += z1[i];
+    }
+}
+
+/******************************************************************************
+ * Multiply two polynomials. Schoolbook multiplication is used for small
+ * polynomials and Karatsuba's algorithm for large ones; see
+ * `select_multiplication`.
  *
  * @param p
  * @param q
@@ -257,25 +1201,70 @@ Polynomial operator*(Polynomial const& p, Polynomial const& q)
         return {};
     }
 
-    // Convolution of two sequences.
     Polynomial result;
     std::size_t p_size = p.size();
     std::size_t q_size = q.size();
-    for(std::size_t n = 0; n < p_size + q_size - 1; ++n)
+    if(select_multiplication(p_size, q_size) == Multiplication::karatsuba)
     {
-        result.push_back(0);
-        for(std::size_t k = 0; k <= n; ++k)
+        // Split the longer polynomial into pieces as long as the shorter one,
+        // and multiply each piece separately.
+        Polynomial const& longer = p_size >= q_size ? p : q;
+        Polynomial const& shorter = p_size >= q_size ? q : p;
+        std::size_t size = shorter.size();
+        result.resize(p_size + q_size - 1);
+        for(std::size_t offset = 0; offset < longer.size(); offset += size)
         {
-            if(k < p_size && n - k < q_size)
+            std::size_t piece = std::min(size, longer.size() - offset);
+            if(piece == size)
+            {
+                karatsuba(longer.data() + offset, shorter.data(), size, result.data() + offset);
+            }
+            else
             {
-                result.back() += p[k] * q[n - k];
+                convolve(longer.data() + offset, piece, shorter.data(), size, result.data() + offset);
             }
         }
+        result.sanitise();
+        return result;
     }
+
+    // Convolution of two sequences.
+    result.resize(p_size + q_size - 1);
+    convolve(p.data(), p_size, q.data(), q_size, result.data());
     result.sanitise();
     return result;
 }
 
+/******************************************************************************
+ * Multiply a polynomial by a scalar in-place.
+ *
+ * @param p
+ * @param d
+ *****************************************************************************/
+void operator*=(Polynomial& p, double d)
+{
+    for(auto& coefficient: p)
+    {
+        coefficient *= d;
+    }
+    p.sanitise();
+}
+
+/******************************************************************************
+ * Multiply a polynomial by a scalar.
+ *
+ * @param p
+ * @param d
+ *
+ * @return Product of the arguments.
+ *****************************************************************************/
+Polynomial operator*(Polynomial const& p, double d)
+{
+    Polynomial result = p;
+    result *= d;
+    return result;
+}
+
 /******************************************************************************
  * Divide a polynomial by a scalar in-place.
  *
@@ -313,7 +1302,7 @@ Polynomial operator/(Polynomial const& p, double d)
  *
  * @return y-coordinate of the polynomial at the given x-coordinate.
  *****************************************************************************/
-double Polynomial::operator()(double x)
+double Polynomial::operator()(double x) const
 {
     double y = 0;
     for(auto it = this->crbegin(); it != this->crend(); it = std::next(it))
@@ -323,6 +1312,29 @@ double Polynomial::operator()(double x)
     return y;
 }
 
+/******************************************************************************
+ * Evaluate the polynomial at several points.
+ *
+ * @param xcoords x-coordinates of the points to evaluate the polynomial at.
+ * @param ycoords Array to write the y-coordinates of the polynomial at the
+ *     given x-coordinates to. It may be the same as `xcoords`.
+ * @param count Number of points.
+ * @param cancellation Token polled periodically, or `nullptr`. If it expires,
+ *     `Expired` is thrown, and only some y-coordinates will have been written.
+ *****************************************************************************/
+void Polynomial::evaluate(double const* xcoords, double* ycoords, std::size_t count,
+                          Cancellation const* cancellation) const
+{
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        if(i % 256 == 0)
+        {
+            check(cancellation);
+        }
+        ycoords[i] = (*this)(xcoords[i]);
+    }
+}
+
 /******************************************************************************
  * Approximate a real number as a rational number with a small denominator.
  * Much of this code is copied from that of the
@@ -0,0 +1,442 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "BigFloat.hh"
+#include "Budget.hh"
+#include "Cancellation.hh"
+#include "DoubleDouble.hh"
+#include "Fraction.hh"
+#include "Input.hh"
+#include "Metrics.hh"
+#include "Polynomial.hh"
+#include "Processing.hh"
+#include "Trace.hh"
+#include "Tuning.hh"
+
+Metrics* metrics = nullptr;
+TraceWriter* trace = nullptr;
+
+/******************************************************************************
+ * Determine which algorithm will construct the interpolating polynomial
+ * passing through a set of points.
+ *
+ * @param points
+ * @param options
+ *
+ * @return Algorithm.
+ *****************************************************************************/
+static Construction construction_of(Points const& points, Options const& options)
+{
+    if(options.y_only)
+    {
+        return Construction::forward_difference;
+    }
+    std::size_t num_of_points = std::min(points.xcoords.size(), points.ycoords.size());
+    return select_construction(num_of_points, classify(points.xcoords, num_of_points), Precision::standard);
+}
+
+/******************************************************************************
+ * Determine which numbers the interpolating polynomial passing through a set
+ * of points will be constructed with.
+ *
+ * @param options
+ *
+ * @return Arithmetic.
+ *****************************************************************************/
+static Arithmetic arithmetic_of(Options const& options)
+{
+    if(options.rational)
+    {
+        return Arithmetic::rational;
+    }
+    if(options.precision > 0)
+    {
+        return Arithmetic::big_float;
+    }
+    if(options.extended)
+    {
+        return Arithmetic::double_double;
+    }
+    return Arithmetic::standard;
+}
+
+/******************************************************************************
+ * Find the interpolating polynomial passing through a set of points exactly,
+ * treating the coordinates as the rational numbers they represent, so that
+ * its coefficients can be displayed in rational form without approximating
+ * them.
+ *
+ * @param points
+ * @param options
+ * @param cancellation
+ *
+ * @return Polynomial.
+ *****************************************************************************/
+static BasicPolynomial<Fraction> exactly(Points const& points, Options const& options,
+                                         Cancellation const* cancellation)
+{
+    std::vector<Fraction> xcoords, ycoords;
+    std::size_t num_of_points = options.y_only ? points.ycoords.size()
+                                               : std::min(points.xcoords.size(), points.ycoords.size());
+    Fraction start(options.start), step(options.step);
+    for(std::size_t i = 0; i < num_of_points; ++i)
+    {
+        xcoords.push_back(options.y_only ? start + Fraction(static_cast<long long>(i)) * step
+                                         : Fraction(points.xcoords[i]));
+        ycoords.push_back(Fraction(points.ycoords[i]));
+    }
+    return BasicPolynomial<Fraction>(xcoords, ycoords, cancellation);
+}
+
+/******************************************************************************
+ * Find the interpolating polynomial passing through a set of points with
+ * coefficients of the requested precision.
+ *
+ * @param points
+ * @param options
+ * @param cancellation
+ *
+ * @return Polynomial.
+ *****************************************************************************/
+static BasicPolynomial<BigFloat> precisely(Points const& points, Options const& options,
+                                           Cancellation const* cancellation)
+{
+    std::vector<BigFloat> xcoords, ycoords;
+    std::size_t num_of_points = options.y_only ? points.ycoords.size()
+                                               : std::min(points.xcoords.size(), points.ycoords.size());
+    BigFloat start(options.start, options.precision), step(options.step, options.precision);
+    for(std::size_t i = 0; i < num_of_points; ++i)
+    {
+        xcoords.push_back(options.y_only ? start + BigFloat(static_cast<double>(i), options.precision) * step
+                                         : BigFloat(points.xcoords[i], options.precision));
+        ycoords.push_back(BigFloat(points.ycoords[i], options.precision));
+    }
+    return BasicPolynomial<BigFloat>(xcoords, ycoords, cancellation);
+}
+
+/******************************************************************************
+ * Find the interpolating polynomial passing through a set of points, and
+ * display it and its values at the requested x-coordinates. The polynomial is
+ * evaluated at a chunk of x-coordinates at a time, and the results written out
+ * before the next chunk is started. Only the time taken to construct and
+ * evaluate the polynomial is reported.
+ *
+ * @param points
+ * @param options
+ * @param out Stream to write the results to.
+ * @param err Stream to write error messages to.
+ * @param polynomial Polynomial passing through the points, if it has already
+ *     been found, else `nullptr`. Moved from.
+ * @param delay Time taken to find `polynomial`.
+ *
+ * @return Exit status.
+ *****************************************************************************/
+int process(Points& points, Options const& options, std::ostream& out, std::ostream& err, Polynomial* polynomial,
+            std::chrono::steady_clock::duration delay)
+{
+    // Without a timeout, the token never expires.
+    std::unique_ptr<Cancellation> cancellation = std::make_unique<Cancellation>();
+    if(options.timeout > 0)
+    {
+        cancellation = std::make_unique<Cancellation>(to_duration(options.timeout));
+    }
+
+    try
+    {
+        auto begin = std::chrono::steady_clock::now();
+        Polynomial p;
+        BasicPolynomial<DoubleDouble> extended;
+        BasicPolynomial<BigFloat> precise;
+        BasicPolynomial<Fraction> exact;
+        // In the y-only mode, the x-coordinates are generated only if the
+        // extended construction or refinement needs them.
+        bool with_big_floats = options.precision > 0 && !options.rational;
+        std::vector<double> generated;
+        if(options.y_only && !with_big_floats && (options.extended || options.refinements > 0))
+        {
+            for(std::size_t i = 0; i < points.ycoords.size(); ++i)
+            {
+                generated.push_back(options.start + i * options.step);
+            }
+        }
+        std::vector<double> const& xcoords = options.y_only ? generated : points.xcoords;
+        if(with_big_floats)
+        {
+            precise = precisely(points, options, cancellation.get());
+        }
+        else if(polynomial != nullptr)
+        {
+            p = std::move(*polynomial);
+        }
+        else if(options.extended)
+        {
+            extended = interpolate_extended(xcoords, points.ycoords, cancellation.get());
+            p = Polynomial(extended);
+        }
+        else if(options.y_only)
+        {
+            p = Polynomial(options.start, options.step, points.ycoords, cancellation.get());
+        }
+        else
+        {
+            p = Polynomial(points.xcoords, points.ycoords, Precision::standard, cancellation.get());
+        }
+        if(options.rational)
+        {
+            exact = exactly(points, options, cancellation.get());
+        }
+        delay += std::chrono::steady_clock::now() - begin;
+        double lost = extended.empty() ? 0 : rounding_error(extended, p, xcoords);
+        std::size_t refinements = 0;
+        if(options.refinements > 0 && precise.empty())
+        {
+            begin = std::chrono::steady_clock::now();
+            refinements = p.refine(xcoords, points.ycoords, options.refinements, cancellation.get());
+            delay += std::chrono::steady_clock::now() - begin;
+        }
+        if(metrics != nullptr)
+        {
+            // Numbers other than `double`s are used to find the Newton form.
+            Arithmetic arithmetic = arithmetic_of(options);
+            Construction construction = construction_of(points, options);
+            if(arithmetic == Arithmetic::double_double)
+            {
+                construction = Construction::newton_leja;
+            }
+            else if(arithmetic != Arithmetic::standard)
+            {
+                construction = Construction::newton;
+            }
+            metrics->record(construction, arithmetic, points.ycoords.size(), delay);
+        }
+        if(options.rational)
+        {
+            out << "[3mp[0m ≡ " << exact << "\n";
+        }
+        else if(!precise.empty())
+        {
+            out << "[3mp[0m ≡ " << precise << "\n";
+        }
+        else
+        {
+            out << "[3mp[0m ≡ " << p << "\n";
+        }
+        if(!extended.empty())
+        {
+            out << "Rounding the coefficients to double changed the terms at the x-coordinates by up to " << lost
+                << " (relative).\n";
+        }
+        if(options.refinements > 0 && precise.empty())
+        {
+            out << "Refined " << refinements << " times; the terms at the x-coordinates are now off by up to "
+                << p.residual(xcoords, points.ycoords) << " (relative).\n";
+        }
+
+        std::size_t const chunk = 1024;
+        std::vector<double> results(std::min(chunk, points.queries.size()));
+        std::chrono::steady_clock::duration evaluation{};
+        for(std::size_t i = 0; i < points.queries.size(); i += chunk)
+        {
+            std::size_t count = std::min(chunk, points.queries.size() - i);
+            if(!precise.empty())
+            {
+                for(std::size_t j = 0; j < count; ++j)
+                {
+                    check(cancellation.get());
+                    begin = std::chrono::steady_clock::now();
+                    BigFloat result = precise(BigFloat(points.queries[i + j], options.precision));
+                    evaluation += std::chrono::steady_clock::now() - begin;
+                    out << "[3mp[0m(" << points.queries[i + j] << ") = " << result << "\n";
+                }
+                continue;
+            }
+            begin = std::chrono::steady_clock::now();
+            p.evaluate(points.queries.data() + i, results.data(), count, cancellation.get());
+            evaluation += std::chrono::steady_clock::now() - begin;
+            for(std::size_t j = 0; j < count; ++j)
+            {
+                out << "[3mp[0m(" << points.queries[i + j] << ") = " << results[j] << "\n";
+            }
+        }
+        delay += evaluation;
+        if(metrics != nullptr)
+        {
+            metrics->record(points.queries.size(), evaluation);
+        }
+    }
+    catch(Expired const& e)
+    {
+        out.flush();
+        err << "Gave up after " << options.timeout << " s. " << e.what() << "\n";
+        if(metrics != nullptr)
+        {
+            metrics->record(Metrics::timed_out);
+        }
+        return EXIT_TIMEOUT;
+    }
+    catch(std::invalid_argument const& e)
+    {
+        out.flush();
+        err << e.what() << "\n";
+        if(metrics != nullptr)
+        {
+            metrics->record(Metrics::failed);
+        }
+        return EXIT_FAILURE;
+    }
+    if(metrics != nullptr)
+    {
+        metrics->record(Metrics::succeeded);
+    }
+    out << "Done in " << std::chrono::duration_cast<std::chrono::microseconds>(delay).count() << " µs.\n";
+    return EXIT_SUCCESS;
+}
+
+/******************************************************************************
+ * Parse a set of points, and add the x-coordinates to evaluate the polynomial
+ * at which are not in the set.
+ *
+ * @param begin Pointer to the first character of the set.
+ * @param end Pointer past the last character of the set.
+ * @param options
+ * @param points Object to store the points in.
+ *****************************************************************************/
+void read_set(char const* begin, char const* end, Options const& options, Points& points)
+{
+    if(options.y_only)
+    {
+        parse_numbers(begin, end, points.ycoords);
+    }
+    else
+    {
+        parse_points(begin, end, points);
+    }
+
+    // The x-coordinates given in the query file are evaluated at after those
+    // in the set. Without any, in the y-only mode, find the next term.
+    points.queries.insert(points.queries.end(), options.queries.begin(), options.queries.end());
+    if(options.y_only && points.queries.empty())
+    {
+        points.queries.push_back(options.start + points.ycoords.size() * options.step);
+    }
+}
+
+/******************************************************************************
+ * Record a set of points in the trace.
+ *
+ * @param points
+ * @param options
+ *****************************************************************************/
+void record_request(Points const& points, Options const& options)
+{
+    Request request;
+    request.y_only = options.y_only;
+    request.start = options.start;
+    request.step = options.step;
+    request.xcoords = points.xcoords;
+    request.ycoords = points.ycoords;
+    request.queries = points.queries;
+    trace->record(request);
+}
+
+/******************************************************************************
+ * Parse a set of points, and record it in the trace, if there is one.
+ *
+ * @param begin Pointer to the first character of the set.
+ * @param end Pointer past the last character of the set.
+ * @param set Number of the set in its input, starting from 1.
+ * @param options
+ * @param points Object to store the points in.
+ * @param err Stream to write error messages to.
+ *
+ * @return Exit status.
+ *****************************************************************************/
+int parse_set(char const* begin, char const* end, std::size_t set, Options const& options, Points& points,
+              std::ostream& err)
+{
+    try
+    {
+        read_set(begin, end, options, points);
+    }
+    catch(std::invalid_argument const& e)
+    {
+        err << "Set " << set << " could not be parsed. " << e.what() << "\n";
+        if(metrics != nullptr)
+        {
+            metrics->record(Metrics::failed);
+        }
+        return EXIT_FAILURE;
+    }
+    if(trace != nullptr)
+    {
+        record_request(points, options);
+    }
+    return EXIT_SUCCESS;
+}
+
+/******************************************************************************
+ * Predict how long `process` will take on a set of points, and how much
+ * memory it will need.
+ *
+ * @param points
+ * @param options
+ *
+ * @return Estimate.
+ *****************************************************************************/
+Estimate estimate(Points const& points, Options const& options)
+{
+    Estimate estimate;
+    std::size_t num_of_points = points.ycoords.size();
+    if(num_of_points <= 1)
+    {
+        return estimate;
+    }
+    std::size_t num_of_queries = std::max<std::size_t>(points.queries.size(), 1);
+    if(!options.y_only)
+    {
+        num_of_points = std::min(num_of_points, points.xcoords.size());
+    }
+    Construction construction = construction_of(points, options);
+    Arithmetic arithmetic = arithmetic_of(options);
+    estimate.cost = predict_cost(num_of_points, construction, arithmetic, options.precision, num_of_queries);
+    estimate.memory = estimate_memory(num_of_points, construction, arithmetic, options.precision, num_of_queries);
+    return estimate;
+}
+
+/******************************************************************************
+ * Process a set of points if the memory it is estimated to need is available,
+ * waiting for it if necessary.
+ *
+ * @param points
+ * @param memory Estimated memory needed, in bytes.
+ * @param set Number of the set in its input, starting from 1.
+ * @param options
+ * @param budget
+ * @param out Stream to write the results to.
+ * @param err Stream to write error messages to.
+ *
+ * @return Exit status.
+ *****************************************************************************/
+int admit(Points& points, std::size_t memory, std::size_t set, Options const& options, Budget& budget,
+          std::ostream& out, std::ostream& err)
+{
+    if(!budget.acquire(memory))
+    {
+        err << "Set " << set << " needs an estimated " << memory << " bytes of memory, more than the budget of "
+            << budget.capacity() << " bytes.\n";
+        if(metrics != nullptr)
+        {
+            metrics->record(Metrics::failed);
+        }
+        return EXIT_FAILURE;
+    }
+    int status = process(points, options, out, err);
+    budget.release(memory);
+    return status;
+}
@@ -0,0 +1,1270 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Rational.hh"
+
+#define THROW(exception, message)  \
+{  \
+    throw exception(std::string(__FILE__) + ':' + std::to_string(__LINE__)  \
+                    + ", in function " + __func__ + ". " + message);  \
+}
+
+// Magnitudes of big integers: 32-bit limbs, least significant first. The
+// functions below which return magnitudes never leave leading zero limbs.
+using Limbs = std::vector<std::uint32_t>;
+
+/******************************************************************************
+ * Remove leading zero limbs.
+ *
+ * @param a
+ *****************************************************************************/
+static void trim(Limbs& a)
+{
+    while(!a.empty() && a.back() == 0)
+    {
+        a.pop_back();
+    }
+}
+
+/******************************************************************************
+ * Compare two magnitudes.
+ *
+ * @param a
+ * @param b
+ *
+ * @return Negative, zero or positive as `a` is less than, equal to or greater
+ *     than `b`.
+ *****************************************************************************/
+static int compare(Limbs const& a, Limbs const& b)
+{
+    if(a.size() != b.size())
+    {
+        return a.size() < b.size() ? -1 : 1;
+    }
+    for(std::size_t i = a.size(); i-- > 0;)
+    {
+        if(a[i] != b[i])
+        {
+            return a[i] < b[i] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+/******************************************************************************
+ * Add two magnitudes.
+ *
+ * @param a
+ * @param b
+ *
+ * @return Sum.
+ *****************************************************************************/
+static Limbs add(Limbs const& a, Limbs const& b)
+{
+    Limbs const& longer = a.size() >= b.size() ? a : b;
+    Limbs const& shorter = a.size() >= b.size() ? b : a;
+    Limbs result(longer.size() + 1);
+    std::uint64_t carry = 0;
+    for(std::size_t i = 0; i < longer.size(); ++i)
+    {
+        carry += static_cast<std::uint64_t>(longer[i]) + (i < shorter.size() ? shorter[i] : 0);
+        result[i] = static_cast<std::uint32_t>(carry);
+        carry >>= 32;
+    }
+    result.back() = static_cast<std::uint32_t>(carry);
+    trim(result);
+    return result;
+}
+
+/******************************************************************************
+ * Subtract a magnitude from another which is not smaller, in place.
+ *
+ * @param a Minuend, replaced by the difference.
+ * @param b Subtrahend.
+ *****************************************************************************/
+static void subtract_from(Limbs& a, Limbs const& b)
+{
+    std::int64_t borrow = 0;
+    for(std::size_t i = 0; i < a.size() && (i < b.size() || borrow != 0); ++i)
+    {
+        std::int64_t difference = static_cast<std::int64_t>(a[i]) - (i < b.size() ? b[i] : 0) - borrow;
+        borrow = difference < 0;
+        a[i] = static_cast<std::uint32_t>(difference);
+    }
+    trim(a);
+}
+
+/******************************************************************************
+ * Multiply two magnitudes using the schoolbook algorithm.
+ *
+ * @param a
+ * @param b
+ *
+ * @return Product.
+ *****************************************************************************/
+static Limbs schoolbook(Limbs const& a, Limbs const& b)
+{
+    if(a.empty() || b.empty())
+    {
+        return {};
+    }
+    Limbs result(a.size() + b.size());
+    for(std::size_t i = 0; i < a.size(); ++i)
+    {
+        std::uint64_t carry = 0;
+        for(std::size_t j = 0; j < b.size(); ++j)
+        {
+            carry += static_cast<std::uint64_t>(a[i]) * b[j] + result[i + j];
+            result[i + j] = static_cast<std::uint32_t>(carry);
+            carry >>= 32;
+        }
+        result[i + b.size()] = static_cast<std::uint32_t>(carry);
+    }
+    trim(result);
+    return result;
+}
+
+/******************************************************************************
+ * Add a magnitude, shifted to the left by a number of limbs, to another, in
+ * place.
+ *
+ * @param a Augend, replaced by the sum.
+ * @param b Addend.
+ * @param limbs Number of limbs to shift `b` by.
+ *****************************************************************************/
+static void add_to(Limbs& a, Limbs const& b, std::size_t limbs)
+{
+    if(a.size() < b.size() + limbs)
+    {
+        a.resize(b.size() + limbs);
+    }
+    std::uint64_t carry = 0;
+    for(std::size_t i = 0; i < b.size() || carry != 0; ++i)
+    {
+        if(i + limbs == a.size())
+        {
+            a.push_back(0);
+        }
+        carry += static_cast<std::uint64_t>(a[i + limbs]) + (i < b.size() ? b[i] : 0);
+        a[i + limbs] = static_cast<std::uint32_t>(carry);
+        carry >>= 32;
+    }
+    trim(a);
+}
+
+// Magnitudes with fewer limbs than this are multiplied using the schoolbook
+// algorithm.
+static std::size_t const karatsuba_min_limbs = 32;
+
+/******************************************************************************
+ * Multiply two magnitudes. Long ones are split in halves, and multiplied using
+ * Karatsuba's algorithm, which needs three products of halves instead of four.
+ * If one is much shorter than the other, only the longer one is split.
+ *
+ * @param a
+ * @param b
+ *
+ * @return Product.
+ *****************************************************************************/
+static Limbs multiply(Limbs const& a, Limbs const& b)
+{
+    if(a.size() < karatsuba_min_limbs || b.size() < karatsuba_min_limbs)
+    {
+        return schoolbook(a, b);
+    }
+    Limbs const& longer = a.size() >= b.size() ? a : b;
+    Limbs const& shorter = a.size() >= b.size() ? b : a;
+    std::size_t half = longer.size() / 2;
+    Limbs longer_low(longer.begin(), longer.begin() + half), longer_high(longer.begin() + half, longer.end());
+    trim(longer_low);
+    if(shorter.size() <= half)
+    {
+        Limbs result = multiply(longer_low, shorter);
+        add_to(result, multiply(longer_high, shorter), half);
+        return result;
+    }
+    Limbs shorter_low(shorter.begin(), shorter.begin() + half), shorter_high(shorter.begin() + half, shorter.end());
+    trim(shorter_low);
+    Limbs low = multiply(longer_low, shorter_low), high = multiply(longer_high, shorter_high);
+    Limbs middle = multiply(add(longer_low, longer_high), add(shorter_low, shorter_high));
+    subtract_from(middle, low);
+    subtract_from(middle, high);
+    Limbs result = low;
+    add_to(result, middle, half);
+    add_to(result, high, 2 * half);
+    return result;
+}
+
+/******************************************************************************
+ * Shift a magnitude to the left.
+ *
+ * @param a
+ * @param bits
+ *
+ * @return `a` times 2 to the power `bits`.
+ *****************************************************************************/
+static Limbs shift_left(Limbs const& a, std::size_t bits)
+{
+    if(a.empty())
+    {
+        return {};
+    }
+    std::size_t limbs = bits / 32, offset = bits % 32;
+    Limbs result(a.size() + limbs + 1);
+    for(std::size_t i = 0; i < a.size(); ++i)
+    {
+        std::uint64_t shifted = static_cast<std::uint64_t>(a[i]) << offset;
+        result[i + limbs] |= static_cast<std::uint32_t>(shifted);
+        result[i + limbs + 1] |= static_cast<std::uint32_t>(shifted >> 32);
+    }
+    trim(result);
+    return result;
+}
+
+/******************************************************************************
+ * Shift a magnitude to the right, in place.
+ *
+ * @param a
+ * @param bits
+ *****************************************************************************/
+static void shift_right(Limbs& a, std::size_t bits)
+{
+    std::size_t limbs = bits / 32, offset = bits % 32;
+    if(limbs >= a.size())
+    {
+        a.clear();
+        return;
+    }
+    for(std::size_t i = 0; i + limbs < a.size(); ++i)
+    {
+        std::uint64_t pair = a[i + limbs];
+        if(i + limbs + 1 < a.size())
+        {
+            pair |= static_cast<std::uint64_t>(a[i + limbs + 1]) << 32;
+        }
+        a[i] = static_cast<std::uint32_t>(pair >> offset);
+    }
+    a.resize(a.size() - limbs);
+    trim(a);
+}
+
+/******************************************************************************
+ * Count the trailing zero bits of a magnitude.
+ *
+ * @param a Must not be zero.
+ *
+ * @return Number of trailing zero bits.
+ *****************************************************************************/
+static std::size_t trailing_zeros(Limbs const& a)
+{
+    std::size_t i = 0;
+    while(a[i] == 0)
+    {
+        ++i;
+    }
+    return 32 * i + __builtin_ctz(a[i]);
+}
+
+/******************************************************************************
+ * Extract 64 bits of a magnitude.
+ *
+ * @param a
+ * @param shift Position of the lowest bit to extract.
+ *
+ * @return `a` shifted right by `shift` bits, truncated to 64 bits.
+ *****************************************************************************/
+static std::uint64_t extract(Limbs const& a, std::size_t shift)
+{
+    std::size_t limb = shift / 32, offset = shift % 32;
+    auto at = [&](std::size_t i) -> std::uint64_t { return i < a.size() ? a[i] : 0; };
+    std::uint64_t result = (at(limb) | at(limb + 1) << 32) >> offset;
+    if(offset > 0)
+    {
+        result |= at(limb + 2) << (64 - offset);
+    }
+    return result;
+}
+
+/******************************************************************************
+ * Divide one magnitude by another using Knuth's algorithm D.
+ *
+ * @param a Dividend.
+ * @param b Divisor. Must not be zero.
+ * @param quotient
+ * @param remainder
+ *****************************************************************************/
+static void divide(Limbs const& a, Limbs const& b, Limbs& quotient, Limbs& remainder)
+{
+    if(compare(a, b) < 0)
+    {
+        quotient.clear();
+        remainder = a;
+        return;
+    }
+    std::size_t n = b.size(), m = a.size() - n;
+    if(n == 1)
+    {
+        quotient.assign(a.size(), 0);
+        std::uint64_t rest = 0;
+        for(std::size_t i = a.size(); i-- > 0;)
+        {
+            rest = rest << 32 | a[i];
+            quotient[i] = static_cast<std::uint32_t>(rest / b[0]);
+            rest %= b[0];
+        }
+        trim(quotient);
+        remainder.assign(1, static_cast<std::uint32_t>(rest));
+        trim(remainder);
+        return;
+    }
+
+    // Normalise so that the most significant bit of the divisor is set. Then
+    // each estimate of a limb of the quotient is at most 2 too large.
+    std::size_t shift = __builtin_clz(b.back());
+    Limbs v = shift_left(b, shift), u = shift_left(a, shift);
+    u.resize(a.size() + 1);
+    quotient.assign(m + 1, 0);
+    std::uint64_t const base = 1ULL << 32;
+    for(std::size_t j = m + 1; j-- > 0;)
+    {
+        std::uint64_t numerator = static_cast<std::uint64_t>(u[j + n]) << 32 | u[j + n - 1];
+        std::uint64_t estimate = numerator / v[n - 1], rest = numerator % v[n - 1];
+        while(estimate >= base || estimate * v[n - 2] > (rest << 32 | u[j + n - 2]))
+        {
+            --estimate;
+            rest += v[n - 1];
+            if(rest >= base)
+            {
+                break;
+            }
+        }
+
+        // Subtract the estimate times the divisor; add the divisor back if
+        // the estimate was one too large.
+        std::int64_t borrow = 0, difference;
+        for(std::size_t i = 0; i < n; ++i)
+        {
+            std::uint64_t product = estimate * v[i];
+            difference = static_cast<std::int64_t>(u[i + j]) - borrow
+                         - static_cast<std::int64_t>(product & 0xFFFFFFFFULL);
+            u[i + j] = static_cast<std::uint32_t>(difference);
+            borrow = static_cast<std::int64_t>(product >> 32) - (difference >> 32);
+        }
+        difference = static_cast<std::int64_t>(u[j + n]) - borrow;
+        u[j + n] = static_cast<std::uint32_t>(difference);
+        if(difference < 0)
+        {
+            --estimate;
+            std::uint64_t carry = 0;
+            for(std::size_t i = 0; i < n; ++i)
+            {
+                carry += static_cast<std::uint64_t>(u[i + j]) + v[i];
+                u[i + j] = static_cast<std::uint32_t>(carry);
+                carry >>= 32;
+            }
+            u[j + n] += static_cast<std::uint32_t>(carry);
+        }
+        quotient[j] = static_cast<std::uint32_t>(estimate);
+    }
+    trim(quotient);
+    u.resize(n);
+    shift_right(u, shift);
+    remainder = std::move(u);
+}
+
+/******************************************************************************
+ * Constructor.
+ *
+ * @param value
+ *****************************************************************************/
+BigInteger::BigInteger(long long value)
+: negative(value < 0)
+{
+    // Negate as unsigned, so that the most negative value is not a problem.
+    unsigned long long magnitude = value < 0 ? 0ULL - static_cast<unsigned long long>(value) : value;
+    for(; magnitude > 0; magnitude >>= 32)
+    {
+        this->limbs.push_back(static_cast<std::uint32_t>(magnitude));
+    }
+}
+
+/******************************************************************************
+ * @return -1, 0 or 1 as this number is negative, zero or positive.
+ *****************************************************************************/
+int BigInteger::sign(void) const
+{
+    return this->limbs.empty() ? 0 : this->negative ? -1 : 1;
+}
+
+/******************************************************************************
+ * @return `true` if this number is zero, else `false`.
+ *****************************************************************************/
+bool BigInteger::is_zero(void) const
+{
+    return this->limbs.empty();
+}
+
+/******************************************************************************
+ * @return Number of bits in the magnitude of this number, not counting
+ *     leading zeros. 0 for zero.
+ *****************************************************************************/
+std::size_t BigInteger::bit_length(void) const
+{
+    return this->limbs.empty() ? 0 : 32 * this->limbs.size() - __builtin_clz(this->limbs.back());
+}
+
+/******************************************************************************
+ * @return Number of trailing zero bits in the magnitude of this number. 0 for
+ *     zero.
+ *****************************************************************************/
+std::size_t BigInteger::trailing_zeros(void) const
+{
+    return this->limbs.empty() ? 0 : ::trailing_zeros(this->limbs);
+}
+
+/******************************************************************************
+ * @return Negation of this number.
+ *****************************************************************************/
+BigInteger BigInteger::operator-(void) const
+{
+    BigInteger result = *this;
+    result.negative = !result.negative && !result.limbs.empty();
+    return result;
+}
+
+/******************************************************************************
+ * @return Magnitude of this number.
+ *****************************************************************************/
+BigInteger BigInteger::abs(void) const
+{
+    BigInteger result = *this;
+    result.negative = false;
+    return result;
+}
+
+/******************************************************************************
+ * @return This number as a floating-point number. Exact if it has at most 53
+ *     significant bits; otherwise, possibly not the nearest.
+ *****************************************************************************/
+double BigInteger::to_double(void) const
+{
+    double result = 0;
+    for(auto it = this->limbs.crbegin(); it != this->limbs.crend(); ++it)
+    {
+        result = std::ldexp(result, 32) + *it;
+    }
+    return this->negative ? -result : result;
+}
+
+/******************************************************************************
+ * @return This number. It must fit in a `long long`.
+ *****************************************************************************/
+long long BigInteger::to_long_long(void) const
+{
+    std::uint64_t magnitude = extract(this->limbs, 0);
+    return this->negative ? -static_cast<long long>(magnitude) : static_cast<long long>(magnitude);
+}
+
+/******************************************************************************
+ * @return Decimal representation of this number.
+ *****************************************************************************/
+std::string BigInteger::to_string(void) const
+{
+    if(this->limbs.empty())
+    {
+        return "0";
+    }
+
+    // Peel off nine decimal digits at a time.
+    std::string digits;
+    Limbs magnitude = this->limbs, quotient, remainder;
+    Limbs const billion = {1000000000U};
+    while(!magnitude.empty())
+    {
+        ::divide(magnitude, billion, quotient, remainder);
+        std::uint32_t chunk = remainder.empty() ? 0 : remainder[0];
+        for(int i = 0; i < 9 && (chunk > 0 || !quotient.empty()); ++i)
+        {
+            digits.push_back('0' + chunk % 10);
+            chunk /= 10;
+        }
+        magnitude.swap(quotient);
+    }
+    if(this->negative)
+    {
+        digits.push_back('-');
+    }
+    std::reverse(digits.begin(), digits.end());
+    return digits;
+}
+
+/******************************************************************************
+ * Compare two integers.
+ *
+ * @param a
+ * @param b
+ *
+ * @return Negative, zero or positive as `a` is less than, equal to or greater
+ *     than `b`.
+ *****************************************************************************/
+int compare(BigInteger const& a, BigInteger const& b)
+{
+    if(a.sign() != b.sign())
+    {
+        return a.sign() < b.sign() ? -1 : 1;
+    }
+    int result = compare(a.limbs, b.limbs);
+    return a.negative ? -result : result;
+}
+
+/******************************************************************************
+ * Add two integers.
+ *
+ * @param a
+ * @param b
+ *
+ * @return Sum.
+ *****************************************************************************/
+BigInteger operator+(BigInteger const& a, BigInteger const& b)
+{
+    BigInteger result;
+    if(a.negative == b.negative)
+    {
+        result.limbs = add(a.limbs, b.limbs);
+        result.negative = a.negative && !result.limbs.empty();
+        return result;
+    }
+    bool larger_a = compare(a.limbs, b.limbs) >= 0;
+    result.limbs = larger_a ? a.limbs : b.limbs;
+    subtract_from(result.limbs, larger_a ? b.limbs : a.limbs);
+    result.negative = (larger_a ? a.negative : b.negative) && !result.limbs.empty();
+    return result;
+}
+
+/******************************************************************************
+ * Subtract one integer from another.
+ *
+ * @param a
+ * @param b
+ *
+ * @return Difference.
+ *****************************************************************************/
+BigInteger operator-(BigInteger const& a, BigInteger const& b)
+{
+    return a + -b;
+}
+
+/******************************************************************************
+ * Multiply two integers.
+ *
+ * @param a
+ * @param b
+ *
+ * @return Product.
+ *****************************************************************************/
+BigInteger operator*(BigInteger const& a, BigInteger const& b)
+{
+    BigInteger result;
+    result.limbs = multiply(a.limbs, b.limbs);
+    result.negative = a.negative != b.negative && !result.limbs.empty();
+    return result;
+}
+
+/******************************************************************************
+ * Divide one integer by another, rounding the quotient towards zero. The
+ * remainder has the sign of the dividend.
+ *
+ * @param a Dividend.
+ * @param b Divisor.
+ * @param quotient
+ * @param remainder
+ *****************************************************************************/
+void divide(BigInteger const& a, BigInteger const& b, BigInteger& quotient, BigInteger& remainder)
+{
+    if(b.is_zero())
+    {
+        THROW(std::domain_error, "Division by zero.")
+    }
+    bool negative_quotient = a.negative != b.negative, negative_remainder = a.negative;
+    divide(a.limbs, b.limbs, quotient.limbs, remainder.limbs);
+    quotient.negative = negative_quotient && !quotient.limbs.empty();
+    remainder.negative = negative_remainder && !remainder.limbs.empty();
+}
+
+/******************************************************************************
+ * Divide one integer by another, rounding towards zero.
+ *
+ * @param a
+ * @param b
+ *
+ * @return Quotient.
+ *****************************************************************************/
+BigInteger operator/(BigInteger const& a, BigInteger const& b)
+{
+    BigInteger quotient, remainder;
+    divide(a, b, quotient, remainder);
+    return quotient;
+}
+
+/******************************************************************************
+ * Find the remainder when dividing one integer by another.
+ *
+ * @param a
+ * @param b
+ *
+ * @return Remainder, with the sign of `a`.
+ *****************************************************************************/
+BigInteger operator%(BigInteger const& a, BigInteger const& b)
+{
+    BigInteger quotient, remainder;
+    divide(a, b, quotient, remainder);
+    return remainder;
+}
+
+/******************************************************************************
+ * Shift the magnitude of an integer to the left, keeping its sign.
+ *
+ * @param a
+ * @param bits
+ *
+ * @return `a` times 2 to the power `bits`.
+ *****************************************************************************/
+BigInteger operator<<(BigInteger const& a, std::size_t bits)
+{
+    BigInteger result;
+    result.limbs = shift_left(a.limbs, bits);
+    result.negative = a.negative;
+    return result;
+}
+
+/******************************************************************************
+ * Shift the magnitude of an integer to the right, keeping its sign.
+ *
+ * @param a
+ * @param bits
+ *
+ * @return `a` divided by 2 to the power `bits`, rounded towards zero.
+ *****************************************************************************/
+BigInteger operator>>(BigInteger const& a, std::size_t bits)
+{
+    BigInteger result = a;
+    shift_right(result.limbs, bits);
+    result.negative = a.negative && !result.limbs.empty();
+    return result;
+}
+
+/******************************************************************************
+ * Find the greatest common divisor of two integers which fit in 64 bits using
+ * the binary algorithm, which needs only shifts and subtractions.
+ *
+ * @param u
+ * @param v
+ *
+ * @return Greatest common divisor. 0 if both are 0.
+ *****************************************************************************/
+std::uint64_t binary_gcd(std::uint64_t u, std::uint64_t v)
+{
+    if(u == 0 || v == 0)
+    {
+        return u | v;
+    }
+    int shift = __builtin_ctzll(u | v);
+    u >>= __builtin_ctzll(u);
+    do
+    {
+        v >>= __builtin_ctzll(v);
+        if(u > v)
+        {
+            std::swap(u, v);
+        }
+        v -= u;
+    }
+    while(v != 0);
+    return u << shift;
+}
+
+/******************************************************************************
+ * Find `a u + b v`, where `a` and `b` do not have the same sign, and the
+ * result is known not to be negative.
+ *
+ * @param u
+ * @param a
+ * @param v
+ * @param b
+ *
+ * @return Result.
+ *****************************************************************************/
+static Limbs combine(Limbs const& u, std::int64_t a, Limbs const& v, std::int64_t b)
+{
+    auto scale = [](Limbs const& x, std::int64_t factor)
+    {
+        std::uint64_t magnitude = factor < 0 ? 0ULL - static_cast<std::uint64_t>(factor) : factor;
+        Limbs limbs = {static_cast<std::uint32_t>(magnitude), static_cast<std::uint32_t>(magnitude >> 32)};
+        trim(limbs);
+        return multiply(x, limbs);
+    };
+    Limbs au = scale(u, a), bv = scale(v, b);
+    if(a > 0)
+    {
+        subtract_from(au, bv);
+        return au;
+    }
+    subtract_from(bv, au);
+    return bv;
+}
+
+/******************************************************************************
+ * Find the greatest common divisor of two integers using Lehmer's algorithm.
+ * Several steps of Euclid's algorithm are worked out from the leading 62 bits
+ * alone, and then applied to the whole numbers at once, so that they shrink by
+ * about 30 bits per pass over them. Once both fit in 64 bits, the binary
+ * algorithm finishes the job.
+ *
+ * @param a
+ * @param b
+ *
+ * @return Greatest common divisor, which is not negative. 0 if both are 0.
+ *****************************************************************************/
+BigInteger gcd(BigInteger const& a, BigInteger const& b)
+{
+    Limbs u = a.limbs, v = b.limbs, quotient, remainder;
+    if(compare(u, v) < 0)
+    {
+        u.swap(v);
+    }
+    while(v.size() > 2)
+    {
+        std::size_t shift = 32 * u.size() - __builtin_clz(u.back()) - 62;
+        std::int64_t uh = extract(u, shift), vh = extract(v, shift);
+        std::int64_t ua = 1, ub = 0, va = 0, vb = 1;
+        while(vh + va != 0 && vh + vb != 0)
+        {
+            std::int64_t q = (uh + ua) / (vh + va);
+            if(q != (uh + ub) / (vh + vb))
+            {
+                break;
+            }
+            std::int64_t t = ua - q * va;
+            ua = va;
+            va = t;
+            t = ub - q * vb;
+            ub = vb;
+            vb = t;
+            t = uh - q * vh;
+            uh = vh;
+            vh = t;
+        }
+        if(ub == 0)
+        {
+            divide(u, v, quotient, remainder);
+            u.swap(v);
+            v.swap(remainder);
+        }
+        else
+        {
+            Limbs w = combine(u, va, v, vb);
+            u = combine(u, ua, v, ub);
+            v.swap(w);
+        }
+    }
+    BigInteger result;
+    if(v.empty())
+    {
+        result.limbs = u;
+        return result;
+    }
+    divide(u, v, quotient, remainder);
+    std::uint64_t divisor = binary_gcd(extract(v, 0), extract(remainder, 0));
+    result.limbs = {static_cast<std::uint32_t>(divisor), static_cast<std::uint32_t>(divisor >> 32)};
+    trim(result.limbs);
+    return result;
+}
+
+bool operator==(BigInteger const& a, BigInteger const& b)
+{
+    return compare(a, b) == 0;
+}
+
+bool operator!=(BigInteger const& a, BigInteger const& b)
+{
+    return compare(a, b) != 0;
+}
+
+bool operator<(BigInteger const& a, BigInteger const& b)
+{
+    return compare(a, b) < 0;
+}
+
+/******************************************************************************
+ * Constructors.
+ *
+ * @param value
+ *****************************************************************************/
+Rational::Rational(int value)
+: numerator(value), denominator(1)
+{
+}
+
+Rational::Rational(long long value)
+: numerator(value), denominator(1)
+{
+}
+
+/******************************************************************************
+ * Constructor. Reduce the fraction to lowest terms.
+ *
+ * @param numerator
+ * @param denominator Must not be zero.
+ *****************************************************************************/
+Rational::Rational(BigInteger const& numerator, BigInteger const& denominator)
+{
+    if(denominator.is_zero())
+    {
+        THROW(std::domain_error, "Denominator is zero.")
+    }
+    BigInteger divisor = gcd(numerator, denominator);
+    if(denominator.sign() < 0)
+    {
+        divisor = -divisor;
+    }
+    this->numerator = numerator / divisor;
+    this->denominator = denominator / divisor;
+}
+
+/******************************************************************************
+ * Constructor. Every finite floating-point number is a rational number with a
+ * power of 2 as its denominator; this is that number, exactly.
+ *
+ * @param value Must be finite.
+ *****************************************************************************/
+Rational::Rational(double value)
+{
+    if(!std::isfinite(value))
+    {
+        THROW(std::invalid_argument, "Expected a finite number, but got " + std::to_string(value) + ".")
+    }
+    int exponent;
+    double fraction = std::frexp(value, &exponent);
+    auto mantissa = static_cast<long long>(std::ldexp(fraction, 53));
+    exponent -= 53;
+    if(exponent >= 0)
+    {
+        this->numerator = BigInteger(mantissa) << exponent;
+        this->denominator = 1;
+        return;
+    }
+    *this = Rational(BigInteger(mantissa), BigInteger(1) << -exponent);
+}
+
+BigInteger const& Rational::get_numerator(void) const
+{
+    return this->numerator;
+}
+
+BigInteger const& Rational::get_denominator(void) const
+{
+    return this->denominator;
+}
+
+/******************************************************************************
+ * @return -1, 0 or 1 as this number is negative, zero or positive.
+ *****************************************************************************/
+int Rational::sign(void) const
+{
+    return this->numerator.sign();
+}
+
+/******************************************************************************
+ * Round this number to the nearest floating-point number (ties to even).
+ *
+ * @return Floating-point number nearest to this number. Infinity if it is too
+ *     large.
+ *****************************************************************************/
+double Rational::to_double(void) const
+{
+    if(this->numerator.is_zero())
+    {
+        return 0;
+    }
+
+    // Find a quotient with at least 55 significant bits, and whether it is
+    // exact. Then round it to as many bits as the result can hold (fewer if
+    // it is subnormal).
+    BigInteger numerator = this->numerator.abs();
+    long long shift = 55 - static_cast<long long>(numerator.bit_length())
+                      + static_cast<long long>(this->denominator.bit_length());
+    BigInteger quotient, remainder;
+    if(shift >= 0)
+    {
+        divide(numerator << shift, this->denominator, quotient, remainder);
+    }
+    else
+    {
+        divide(numerator, this->denominator << -shift, quotient, remainder);
+    }
+    long long length = quotient.bit_length();
+    long long exponent = length - 1 - shift;
+    long long precision = std::numeric_limits<double>::digits;
+    long long const min_exponent = std::numeric_limits<double>::min_exponent - 1;
+    if(exponent < min_exponent)
+    {
+        precision = std::max(precision - (min_exponent - exponent), 0LL);
+    }
+    std::size_t dropped = length - precision;
+    BigInteger kept = quotient >> dropped;
+    BigInteger rest = quotient - (kept << dropped);
+    BigInteger half = BigInteger(1) << (dropped - 1);
+    int comparison = compare(rest, half);
+    bool odd = kept.trailing_zeros() == 0 && !kept.is_zero();
+    if(comparison > 0 || (comparison == 0 && (!remainder.is_zero() || odd)))
+    {
+        kept = kept + 1;
+    }
+
+    // What is kept has at most 54 bits, so it converts exactly.
+    double result = std::ldexp(kept.to_double(), static_cast<int>(dropped - shift));
+    return this->numerator.sign() < 0 ? -result : result;
+}
+
+/******************************************************************************
+ * @return This number as `numerator/denominator`, or as an integer if the
+ *     denominator is 1.
+ *****************************************************************************/
+std::string Rational::to_string(void) const
+{
+    if(this->denominator == 1)
+    {
+        return this->numerator.to_string();
+    }
+    return this->numerator.to_string() + '/' + this->denominator.to_string();
+}
+
+/******************************************************************************
+ * Add two rational numbers. Dividing the denominators by their greatest
+ * common divisor first keeps the numbers small.
+ *
+ * @param a
+ * @param b
+ *
+ * @return Sum.
+ *****************************************************************************/
+Rational operator+(Rational const& a, Rational const& b)
+{
+    if(a.numerator.is_zero())
+    {
+        return b;
+    }
+    if(b.numerator.is_zero())
+    {
+        return a;
+    }
+    BigInteger divisor = gcd(a.denominator, b.denominator);
+    Rational result;
+    if(divisor == 1)
+    {
+        result.numerator = a.numerator * b.denominator + b.numerator * a.denominator;
+        result.denominator = a.denominator * b.denominator;
+        return result;
+    }
+    BigInteger a_cofactor = a.denominator / divisor, b_cofactor = b.denominator / divisor;
+    BigInteger numerator = a.numerator * b_cofactor + b.numerator * a_cofactor;
+    if(numerator.is_zero())
+    {
+        return result;
+    }
+    BigInteger common = gcd(numerator, divisor);
+    result.numerator = numerator / common;
+    result.denominator = a_cofactor * (b.denominator / common);
+    return result;
+}
+
+/******************************************************************************
+ * Multiply two rational numbers. Cancelling each numerator against the other
+ * denominator first keeps the numbers small.
+ *
+ * @param a
+ * @param b
+ *
+ * @return Product.
+ *****************************************************************************/
+Rational operator*(Rational const& a, Rational const& b)
+{
+    Rational result;
+    if(a.numerator.is_zero() || b.numerator.is_zero())
+    {
+        return result;
+    }
+    BigInteger ad = gcd(a.numerator, b.denominator), bc = gcd(b.numerator, a.denominator);
+    result.numerator = (a.numerator / ad) * (b.numerator / bc);
+    result.denominator = (a.denominator / bc) * (b.denominator / ad);
+    return result;
+}
+
+/******************************************************************************
+ * @param a
+ *
+ * @return Negation.
+ *****************************************************************************/
+Rational operator-(Rational const& a)
+{
+    Rational result = a;
+    result.numerator = -result.numerator;
+    return result;
+}
+
+/******************************************************************************
+ * @param a Must not be zero.
+ *
+ * @return Reciprocal.
+ *****************************************************************************/
+Rational reciprocal(Rational const& a)
+{
+    if(a.numerator.is_zero())
+    {
+        THROW(std::domain_error, "Division by zero.")
+    }
+    Rational result;
+    result.numerator = a.numerator.sign() < 0 ? -a.denominator : a.denominator;
+    result.denominator = a.numerator.abs();
+    return result;
+}
+
+Rational operator-(Rational const& a, Rational const& b)
+{
+    return a + -b;
+}
+
+Rational operator/(Rational const& a, Rational const& b)
+{
+    return a * reciprocal(b);
+}
+
+void operator+=(Rational& a, Rational const& b)
+{
+    a = a + b;
+}
+
+void operator-=(Rational& a, Rational const& b)
+{
+    a = a - b;
+}
+
+void operator*=(Rational& a, Rational const& b)
+{
+    a = a * b;
+}
+
+void operator/=(Rational& a, Rational const& b)
+{
+    a = a / b;
+}
+
+bool operator==(Rational const& a, Rational const& b)
+{
+    return a.get_numerator() == b.get_numerator() && a.get_denominator() == b.get_denominator();
+}
+
+bool operator!=(Rational const& a, Rational const& b)
+{
+    return !(a == b);
+}
+
+bool operator<(Rational const& a, Rational const& b)
+{
+    return (a - b).sign() < 0;
+}
+
+/******************************************************************************
+ * Write rational numbers as integers over a common denominator.
+ *
+ * @param numbers
+ * @param integers Array to store the numerators in.
+ *
+ * @return Least common denominator.
+ *****************************************************************************/
+static BigInteger scale(std::vector<Rational> const& numbers, std::vector<BigInteger>& integers)
+{
+    BigInteger denominator = 1;
+    for(auto const& number: numbers)
+    {
+        BigInteger const& d = number.get_denominator();
+        denominator = denominator * (d / gcd(denominator, d));
+    }
+    integers.clear();
+    for(auto const& number: numbers)
+    {
+        integers.push_back(number.get_numerator() * (denominator / number.get_denominator()));
+    }
+    return denominator;
+}
+
+/******************************************************************************
+ * Find the products of the differences between each node and the others, and
+ * their least common multiple.
+ *
+ * @param nodes Integers.
+ * @param xcoords Used only to report duplicates.
+ * @param products Array to store the products in.
+ * @param cancellation Polled once per node.
+ *
+ * @return Least common multiple of the products, which is positive.
+ *****************************************************************************/
+static BigInteger node_products(std::vector<BigInteger> const& nodes, std::vector<double> const& xcoords,
+                                std::vector<BigInteger>& products, Cancellation const* cancellation)
+{
+    BigInteger multiple = 1;
+    products.assign(nodes.size(), 1);
+    for(std::size_t i = 0; i < nodes.size(); ++i)
+    {
+        check(cancellation);
+        for(std::size_t j = 0; j < nodes.size(); ++j)
+        {
+            if(j != i)
+            {
+                products[i] = products[i] * (nodes[i] - nodes[j]);
+            }
+        }
+        if(products[i].is_zero())
+        {
+            auto str_xcoord = std::to_string(xcoords[i]);
+            std::string message = "Expected distinct x-coordinates, but " + str_xcoord + " occurs multiple times.";
+            THROW(std::invalid_argument, message)
+        }
+        BigInteger product = products[i].abs();
+        multiple = multiple * (product / gcd(multiple, product));
+    }
+    return multiple;
+}
+
+/******************************************************************************
+ * Find the coefficients of the interpolating polynomial exactly, treating the
+ * given coordinates as the rational numbers they represent. This is far
+ * slower than any of the algorithms of `Polynomial` (the numbers involved may
+ * have tens of thousands of digits), but has no rounding errors at all, so it
+ * serves as the reference against which they are measured.
+ *
+ * The coordinates are scaled to integers, so that the Lagrange form can be
+ * summed over a single common denominator, and each coefficient reduced to
+ * lowest terms only once, at the end.
+ *
+ * @param xcoords
+ * @param ycoords
+ * @param cancellation Polled once per point.
+ *
+ * @return Coefficients, starting with the constant term.
+ *****************************************************************************/
+std::vector<Rational> interpolate_exactly(std::vector<double> const& xcoords, std::vector<double> const& ycoords,
+                                          Cancellation const* cancellation)
+{
+    std::size_t num_of_points = std::min(xcoords.size(), ycoords.size());
+    if(num_of_points <= 1)
+    {
+        THROW(std::invalid_argument, "At least two points are required for interpolation.")
+    }
+    std::vector<Rational> xs, ys;
+    for(std::size_t i = 0; i < num_of_points; ++i)
+    {
+        xs.push_back(Rational(xcoords[i]));
+        ys.push_back(Rational(ycoords[i]));
+    }
+    std::vector<BigInteger> nodes, values, products;
+    BigInteger x_scale = scale(xs, nodes), y_scale = scale(ys, values);
+    BigInteger denominator = node_products(nodes, xcoords, products, cancellation);
+
+    // The product of all the factors, from which each Lagrange basis
+    // polynomial is found by dividing out one factor.
+    std::vector<BigInteger> full(1, 1);
+    for(auto const& node: nodes)
+    {
+        full.insert(full.begin(), 0);
+        for(std::size_t k = 0; k + 1 < full.size(); ++k)
+        {
+            full[k] = full[k] - node * full[k + 1];
+        }
+    }
+    std::vector<BigInteger> numerators(num_of_points), basis(num_of_points);
+    for(std::size_t i = 0; i < num_of_points; ++i)
+    {
+        check(cancellation);
+        basis[num_of_points - 1] = full[num_of_points];
+        for(std::size_t k = num_of_points - 1; k > 0; --k)
+        {
+            basis[k - 1] = full[k] + nodes[i] * basis[k];
+        }
+        BigInteger weight = values[i] * (denominator / products[i]);
+        for(std::size_t k = 0; k < num_of_points; ++k)
+        {
+            numerators[k] = numerators[k] + weight * basis[k];
+        }
+    }
+
+    // Undo the scaling: the coefficient of the kth power is multiplied by the
+    // kth power of the scale of the x-coordinates.
+    std::vector<Rational> coefficients;
+    BigInteger power = 1;
+    for(std::size_t k = 0; k < num_of_points; ++k)
+    {
+        coefficients.push_back(Rational(numerators[k] * power, denominator * y_scale));
+        power = power * x_scale;
+    }
+    return coefficients;
+}
+
+/******************************************************************************
+ * Evaluate the interpolating polynomial exactly at a point, using the Lagrange
+ * form, which is much faster than evaluating the exact coefficients.
+ *
+ * @param xcoords
+ * @param ycoords
+ * @param x
+ *
+ * @return Value.
+ *****************************************************************************/
+Rational evaluate_exactly(std::vector<double> const& xcoords, std::vector<double> const& ycoords, double x)
+{
+    std::size_t num_of_points = std::min(xcoords.size(), ycoords.size());
+    if(num_of_points <= 1)
+    {
+        THROW(std::invalid_argument, "At least two points are required for interpolation.")
+    }
+    std::vector<Rational> xs, ys;
+    for(std::size_t i = 0; i < num_of_points; ++i)
+    {
+        xs.push_back(Rational(xcoords[i]));
+        ys.push_back(Rational(ycoords[i]));
+    }
+    xs.push_back(Rational(x));
+    std::vector<BigInteger> nodes, values, products;
+    scale(xs, nodes);
+    BigInteger y_scale = scale(ys, values);
+    BigInteger query = nodes.back();
+    nodes.pop_back();
+    for(std::size_t i = 0; i < num_of_points; ++i)
+    {
+        if(nodes[i] == query)
+        {
+            return ys[i];
+        }
+    }
+    BigInteger denominator = node_products(nodes, xcoords, products, nullptr);
+
+    // Every term has all but one of the factors (x - x_j), so multiply by all
+    // of them and divide out the missing one.
+    BigInteger numerator, full = 1;
+    for(auto const& node: nodes)
+    {
+        full = full * (query - node);
+    }
+    for(std::size_t i = 0; i < num_of_points; ++i)
+    {
+        numerator = numerator + values[i] * (denominator / products[i]) * (full / (query - nodes[i]));
+    }
+    return Rational(numerator, denominator * y_scale);
+}
@@ -0,0 +1,166 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "Cancellation.hh"
+#include "Channel.hh"
+#include "Metrics.hh"
+#include "Polynomial.hh"
+#include "Processing.hh"
+#include "Server.hh"
+#include "Trace.hh"
+#include "Tuning.hh"
+
+// Channel being served, closed by the handler of `SIGINT` and `SIGTERM`.
+static std::atomic<Channel*> serving(nullptr);
+static_assert(std::atomic<Channel*>::is_always_lock_free, "The signal handler needs a lock-free pointer.");
+
+/******************************************************************************
+ * Stop serving.
+ *
+ * @param signal Ignored.
+ *****************************************************************************/
+static void interrupt(int)
+{
+    Channel* channel = serving.load();
+    if(channel != nullptr)
+    {
+        channel->close();
+    }
+}
+
+/******************************************************************************
+ * Find the interpolating polynomial passing through the points in a slot of a
+ * channel, and write its coefficients and its values at the queries into the
+ * same slot.
+ *
+ * @param slot
+ * @param options
+ *****************************************************************************/
+static void respond(Slot const& slot, Options const& options)
+{
+    Descriptor& descriptor = *slot.descriptor;
+    std::unique_ptr<Cancellation> cancellation = std::make_unique<Cancellation>();
+    if(options.timeout > 0)
+    {
+        cancellation = std::make_unique<Cancellation>(to_duration(options.timeout));
+    }
+    descriptor.num_of_coefficients = 0;
+    descriptor.message[0] = '\0';
+    int status = EXIT_SUCCESS;
+    try
+    {
+        std::vector<double> xcoords(slot.xcoords, slot.xcoords + slot.num_of_points);
+        std::vector<double> ycoords(slot.ycoords, slot.ycoords + slot.num_of_points);
+        if(trace != nullptr)
+        {
+            Request request;
+            request.xcoords = xcoords;
+            request.ycoords = ycoords;
+            request.queries.assign(slot.queries, slot.queries + slot.num_of_queries);
+            trace->record(request);
+        }
+        auto begin = std::chrono::steady_clock::now();
+        Polynomial p(xcoords, ycoords, Precision::standard, cancellation.get());
+        auto middle = std::chrono::steady_clock::now();
+        p.evaluate(slot.queries, slot.values, slot.num_of_queries, cancellation.get());
+        if(metrics != nullptr)
+        {
+            auto end = std::chrono::steady_clock::now();
+            Nodes nodes = classify(xcoords, xcoords.size());
+            metrics->record(select_construction(xcoords.size(), nodes, Precision::standard), Arithmetic::standard,
+                            xcoords.size(), middle - begin);
+            metrics->record(slot.num_of_queries, end - middle);
+        }
+        std::size_t num_of_coefficients = std::min(p.size(), slot.num_of_points);
+        std::copy(p.begin(), p.begin() + num_of_coefficients, slot.coefficients);
+        descriptor.num_of_coefficients = num_of_coefficients;
+    }
+    catch(std::exception const& e)
+    {
+        status = dynamic_cast<Expired const*>(&e) != nullptr ? EXIT_TIMEOUT : EXIT_FAILURE;
+        std::strncpy(descriptor.message, e.what(), sizeof descriptor.message - 1);
+        descriptor.message[sizeof descriptor.message - 1] = '\0';
+    }
+    descriptor.status = status;
+    if(metrics != nullptr)
+    {
+        metrics->record(status == EXIT_SUCCESS   ? Metrics::succeeded
+                        : status == EXIT_TIMEOUT ? Metrics::timed_out
+                                                 : Metrics::failed);
+    }
+}
+
+/******************************************************************************
+ * Serve requests submitted through a shared memory channel by processes on
+ * the same machine (see `Channel`), until interrupted.
+ *
+ * @param name Name of the channel.
+ * @param num_of_slots Number of requests which may be outstanding at once.
+ * @param slot_capacity Number of numbers each slot can hold.
+ * @param options
+ * @param num_of_threads Number of threads serving requests.
+ *
+ * @return Exit status.
+ *****************************************************************************/
+int serve(char const* name, std::size_t num_of_slots, std::size_t slot_capacity, Options const& options,
+          std::size_t num_of_threads)
+{
+    std::unique_ptr<Channel> channel;
+    try
+    {
+        channel = std::make_unique<Channel>(name, num_of_slots, slot_capacity);
+    }
+    catch(std::exception const& e)
+    {
+        std::cerr << e.what() << "\n";
+        return EXIT_FAILURE;
+    }
+    serving = channel.get();
+    std::signal(SIGINT, interrupt);
+    std::signal(SIGTERM, interrupt);
+    std::cerr << "Serving " << name << " with " << num_of_slots << " slots of " << slot_capacity << " numbers.\n";
+
+    if(metrics != nullptr)
+    {
+        metrics->gauge("lagrange_queue_depth", "Requests waiting to be received.", "queue=\"channel\"",
+                       [&]{ return channel->pending(); });
+    }
+
+    std::atomic<std::size_t> num_of_requests(0);
+    auto work = [&]
+    {
+        Slot slot;
+        while(channel->receive(slot))
+        {
+            respond(slot, options);
+            channel->respond(slot);
+            ++num_of_requests;
+        }
+    };
+    std::vector<std::thread> threads;
+    for(std::size_t i = 0; i < num_of_threads; ++i)
+    {
+        threads.emplace_back(work);
+    }
+    for(auto& thread: threads)
+    {
+        thread.join();
+    }
+    serving = nullptr;
+    if(metrics != nullptr)
+    {
+        metrics->stop();
+    }
+    std::cerr << "Served " << num_of_requests << " requests.\n";
+    return EXIT_SUCCESS;
+}
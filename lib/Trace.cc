@@ -0,0 +1,216 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Trace.hh"
+
+#define THROW(exception, message)  \
+{  \
+    throw exception(std::string(__FILE__) + ':' + std::to_string(__LINE__)  \
+                    + ", in function " + __func__ + ". " + message);  \
+}
+
+// A trace starts with these 8 bytes, which identify it and the version of its
+// format. Each request follows as a `Record`, then the starting x-coordinate
+// and the step (y-only mode) or the x-coordinates (otherwise), then the
+// y-coordinates, then the queries, all in the byte order of the machine.
+#define TRACE_MAGIC "LIPTRC01"
+
+// Fixed part of a recorded request.
+struct Record
+{
+    std::uint64_t time;
+    std::uint32_t num_of_points, num_of_queries;
+    std::uint32_t flags, reserved;
+};
+
+// Flags of a recorded request.
+#define TRACE_Y_ONLY 1U
+
+/******************************************************************************
+ * Constructor. Create a trace, replacing any existing file.
+ *
+ * @param path
+ *****************************************************************************/
+TraceWriter::TraceWriter(char const* path)
+: file(std::fopen(path, "wb")), path(path), failed(false), epoch(std::chrono::steady_clock::now())
+{
+    if(this->file == nullptr || std::fwrite(TRACE_MAGIC, 1, 8, this->file) != 8)
+    {
+        if(this->file != nullptr)
+        {
+            std::fclose(this->file);
+        }
+        THROW(std::runtime_error, "File " + std::string(path) + " could not be written.")
+    }
+}
+
+/******************************************************************************
+ * Destructor. Close the trace, if `close` has not, without reporting whether
+ * it could be written.
+ *****************************************************************************/
+TraceWriter::~TraceWriter()
+{
+    if(this->file != nullptr)
+    {
+        std::fclose(this->file);
+    }
+}
+
+/******************************************************************************
+ * Close the trace. Nothing may be recorded afterwards.
+ *****************************************************************************/
+void TraceWriter::close(void)
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    bool closed = std::fclose(this->file) == 0;
+    this->file = nullptr;
+    if(this->failed || !closed)
+    {
+        THROW(std::runtime_error, "File " + this->path + " could not be written completely.")
+    }
+}
+
+/******************************************************************************
+ * Record a request, with the current time.
+ *
+ * @param request Its time is ignored.
+ *****************************************************************************/
+void TraceWriter::record(Request const& request)
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->write(request, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now()
+                                                                               - this->epoch).count());
+}
+
+/******************************************************************************
+ * Record a request, with the given time. This is meant for writing synthetic
+ * traces, in which the times need not be those at which `record` is called.
+ *
+ * @param request Its time is ignored.
+ * @param time Time since recording started, in nanoseconds.
+ *****************************************************************************/
+void TraceWriter::record(Request const& request, std::uint64_t time)
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->write(request, time);
+}
+
+/******************************************************************************
+ * Write a request. The caller must hold the lock. After a write fails, nothing
+ * more is written, since the requests after one written in part could not be
+ * read back; the failure is reported by `close`.
+ *
+ * @param request
+ * @param time
+ *****************************************************************************/
+void TraceWriter::write(Request const& request, std::uint64_t time)
+{
+    if(this->failed)
+    {
+        return;
+    }
+    Record record = {};
+    record.time = time;
+    record.num_of_points = request.y_only ? request.ycoords.size()
+                                          : std::min(request.xcoords.size(), request.ycoords.size());
+    record.num_of_queries = request.queries.size();
+    record.flags = request.y_only ? TRACE_Y_ONLY : 0;
+    bool written = std::fwrite(&record, sizeof record, 1, this->file) == 1;
+    if(request.y_only)
+    {
+        double spacing[] = {request.start, request.step};
+        written = written && std::fwrite(spacing, sizeof spacing, 1, this->file) == 1;
+    }
+    else
+    {
+        written = written
+                  && std::fwrite(request.xcoords.data(), sizeof(double), record.num_of_points, this->file)
+                     == record.num_of_points;
+    }
+    written = written
+              && std::fwrite(request.ycoords.data(), sizeof(double), record.num_of_points, this->file)
+                 == record.num_of_points
+              && std::fwrite(request.queries.data(), sizeof(double), record.num_of_queries, this->file)
+                 == record.num_of_queries;
+    this->failed = !written;
+}
+
+/******************************************************************************
+ * Constructor. Open a trace.
+ *
+ * @param path
+ *****************************************************************************/
+TraceReader::TraceReader(char const* path)
+: file(std::fopen(path, "rb"))
+{
+    char magic[8];
+    if(this->file == nullptr)
+    {
+        THROW(std::runtime_error, "File " + std::string(path) + " could not be read.")
+    }
+    if(std::fread(magic, 1, 8, this->file) != 8 || std::memcmp(magic, TRACE_MAGIC, 8) != 0)
+    {
+        std::fclose(this->file);
+        THROW(std::runtime_error, "File " + std::string(path) + " is not a trace.")
+    }
+}
+
+/******************************************************************************
+ * Destructor.
+ *****************************************************************************/
+TraceReader::~TraceReader()
+{
+    std::fclose(this->file);
+}
+
+/******************************************************************************
+ * Read the next request.
+ *
+ * @param request Object to store the request in.
+ *
+ * @return `true` if a request was read, `false` if there are no more.
+ *****************************************************************************/
+bool TraceReader::next(Request& request)
+{
+    Record record;
+    if(std::fread(&record, sizeof record, 1, this->file) != 1)
+    {
+        return false;
+    }
+    request.time = record.time;
+    request.y_only = (record.flags & TRACE_Y_ONLY) != 0;
+    request.xcoords.clear();
+    request.ycoords.resize(record.num_of_points);
+    request.queries.resize(record.num_of_queries);
+    bool complete = true;
+    if(request.y_only)
+    {
+        double spacing[2];
+        complete = std::fread(spacing, sizeof spacing, 1, this->file) == 1;
+        request.start = spacing[0];
+        request.step = spacing[1];
+    }
+    else
+    {
+        request.xcoords.resize(record.num_of_points);
+        complete = std::fread(request.xcoords.data(), sizeof(double), record.num_of_points, this->file)
+                   == record.num_of_points;
+    }
+    complete = complete
+               && std::fread(request.ycoords.data(), sizeof(double), record.num_of_points, this->file)
+                  == record.num_of_points
+               && std::fread(request.queries.data(), sizeof(double), record.num_of_queries, this->file)
+                  == record.num_of_queries;
+    if(!complete)
+    {
+        THROW(std::runtime_error, "Trace ends in the middle of a request.")
+    }
+    return true;
+}
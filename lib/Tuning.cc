@@ -0,0 +1,389 @@
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "Tuning.hh"
+
+// Location of the tuning file written by the autotuner, relative to the
+// working directory. The environment variable `LAGRANGE_TUNING`, if set, takes
+// precedence.
+#ifndef LAGRANGE_TUNING_FILE
+#define LAGRANGE_TUNING_FILE "lagrange.tuning"
+#endif
+
+// Names of the fields of the tuning table, as they appear in the tuning file.
+// Each field is either an integer or a real number; neither may be negative.
+struct Field
+{
+    char const* name;
+    std::size_t Tuning::* integer;
+    double Tuning::* real;
+};
+static Field const fields[] =
+{
+    {"newton_min_points", &Tuning::newton_min_points, nullptr},
+    {"karatsuba_min_size", &Tuning::karatsuba_min_size, nullptr},
+    {"parallel_weights_min_points", &Tuning::parallel_weights_min_points, nullptr},
+    {"node_tolerance", nullptr, &Tuning::node_tolerance},
+    {"cost_overhead", nullptr, &Tuning::cost_overhead},
+    {"cost_lagrange", nullptr, &Tuning::cost_lagrange},
+    {"cost_newton", nullptr, &Tuning::cost_newton},
+    {"cost_newton_leja", nullptr, &Tuning::cost_newton_leja},
+    {"cost_forward_difference", nullptr, &Tuning::cost_forward_difference},
+    {"cost_bjorck_pereyra", nullptr, &Tuning::cost_bjorck_pereyra},
+    {"cost_evaluation", nullptr, &Tuning::cost_evaluation},
+    {"cost_double_double", nullptr, &Tuning::cost_double_double},
+    {"cost_big_float", nullptr, &Tuning::cost_big_float},
+    {"cost_rational", nullptr, &Tuning::cost_rational},
+};
+
+/******************************************************************************
+ * Obtain the table of thresholds used to choose algorithms. On the first call,
+ * it is read from the tuning file (falling back to the built-in defaults for
+ * any fields missing from it); subsequent calls merely return it. It may be
+ * modified at runtime, but not while polynomials are being constructed or
+ * multiplied on other threads.
+ *
+ * @return Thresholds.
+ *****************************************************************************/
+Tuning& tuning(void)
+{
+    static Tuning table = []
+    {
+        Tuning table_;
+        char const* path = std::getenv("LAGRANGE_TUNING");
+        load_tuning(path == nullptr ? LAGRANGE_TUNING_FILE : path, table_);
+        return table_;
+    }();
+    return table;
+}
+
+/******************************************************************************
+ * Read thresholds from a tuning file. Each line of the file must contain the
+ * name of a field and its value, separated by whitespace. Empty lines, lines
+ * starting with `#` and lines which cannot be parsed are ignored, as are
+ * values which are negative, out of range or not finite.
+ *
+ * @param path Tuning file.
+ * @param table Thresholds. Fields not present in the file are not modified.
+ *
+ * @return `true` if the file could be read, else `false`.
+ *****************************************************************************/
+bool load_tuning(char const* path, Tuning& table)
+{
+    std::FILE* file = std::fopen(path, "r");
+    if(file == nullptr)
+    {
+        return false;
+    }
+    char line[256];
+    while(std::fgets(line, sizeof line, file) != nullptr)
+    {
+        char* value = line + std::strcspn(line, " \t");
+        if(line[0] == '#' || *value == '\0')
+        {
+            continue;
+        }
+        *value++ = '\0';
+        for(auto const& field: fields)
+        {
+            if(std::strcmp(field.name, line) != 0)
+            {
+                continue;
+            }
+            // `std::strtoull` accepts a minus sign, and negates the result.
+            value += std::strspn(value, " \t");
+            char* end;
+            errno = 0;
+            if(field.integer != nullptr)
+            {
+                auto integer = std::strtoull(value, &end, 10);
+                if(*value != '-' && end != value && errno == 0 && end[std::strspn(end, " \t\r\n")] == '\0')
+                {
+                    table.*field.integer = integer;
+                }
+            }
+            else
+            {
+                double real = std::strtod(value, &end);
+                if(std::isfinite(real) && real >= 0 && end != value && errno == 0
+                   && end[std::strspn(end, " \t\r\n")] == '\0')
+                {
+                    table.*field.real = real;
+                }
+            }
+        }
+    }
+    std::fclose(file);
+    return true;
+}
+
+/******************************************************************************
+ * Write thresholds to a tuning file, in the format understood by
+ * `load_tuning`.
+ *
+ * @param path Tuning file.
+ * @param table Thresholds.
+ *
+ * @return `true` if the file could be written, else `false`.
+ *****************************************************************************/
+bool save_tuning(char const* path, Tuning const& table)
+{
+    std::FILE* file = std::fopen(path, "w");
+    if(file == nullptr)
+    {
+        return false;
+    }
+    std::fprintf(file, "# Written by the autotuner. Delete this file to restore the defaults.\n");
+    for(auto const& field: fields)
+    {
+        if(field.integer != nullptr)
+        {
+            std::fprintf(file, "%s %zu\n", field.name, table.*field.integer);
+        }
+        else
+        {
+            std::fprintf(file, "%s %.17g\n", field.name, table.*field.real);
+        }
+    }
+    return std::fclose(file) == 0;
+}
+
+/******************************************************************************
+ * Check whether the given sorted coordinates are Chebyshev nodes (of either
+ * the first or the second kind) on some interval.
+ *
+ * @param sorted x-coordinates in increasing order.
+ * @param tolerance Maximum deviation from a Chebyshev node, relative to the
+ *     half-width of the interval.
+ *
+ * @return `true` if they are Chebyshev nodes, else `false`.
+ *****************************************************************************/
+static bool is_chebyshev(std::vector<double> const& sorted, double tolerance)
+{
+    double const pi = std::acos(-1.0);
+    std::size_t num_of_points = sorted.size();
+    double centre = (sorted.front() + sorted.back()) / 2;
+    double half_width = (sorted.back() - sorted.front()) / 2;
+
+    // Nodes of the first kind do not include the endpoints of the interval;
+    // those of the second kind do.
+    double first_radius = half_width / std::cos(pi / (2 * num_of_points));
+    double second_radius = half_width;
+    bool first = true;
+    bool second = true;
+    for(std::size_t k = 0; k < num_of_points && (first || second); ++k)
+    {
+        double x = sorted[num_of_points - 1 - k];
+        double first_node = centre + first_radius * std::cos((2 * k + 1) * pi / (2 * num_of_points));
+        double second_node = centre + second_radius * std::cos(k * pi / (num_of_points - 1));
+        first = first && std::abs(x - first_node) <= tolerance * half_width;
+        second = second && std::abs(x - second_node) <= tolerance * half_width;
+    }
+    return first || second;
+}
+
+/******************************************************************************
+ * Determine the structure of a set of x-coordinates.
+ *
+ * @param xcoords
+ * @param num_of_points Number of x-coordinates to consider.
+ *
+ * @return `Nodes::equispaced` if consecutive x-coordinates have the same
+ *     difference, `Nodes::chebyshev` if the x-coordinates (in any order) are
+ *     Chebyshev nodes and `Nodes::arbitrary` otherwise.
+ *****************************************************************************/
+Nodes classify(std::vector<double> const& xcoords, std::size_t num_of_points)
+{
+    double tolerance = tuning().node_tolerance;
+    if(num_of_points < 3)
+    {
+        return Nodes::equispaced;
+    }
+
+    double step = (xcoords[num_of_points - 1] - xcoords[0]) / (num_of_points - 1);
+    bool equispaced = true;
+    for(std::size_t i = 1; i < num_of_points - 1 && equispaced; ++i)
+    {
+        equispaced = std::abs(xcoords[i] - (xcoords[0] + i * step)) <= tolerance * std::abs(step);
+    }
+    if(equispaced)
+    {
+        return Nodes::equispaced;
+    }
+
+    std::vector<double> sorted(xcoords.begin(), xcoords.begin() + num_of_points);
+    std::sort(sorted.begin(), sorted.end());
+    if(is_chebyshev(sorted, tolerance))
+    {
+        return Nodes::chebyshev;
+    }
+    return Nodes::arbitrary;
+}
+
+/******************************************************************************
+ * Choose an algorithm to construct the interpolating polynomial. Fewer points
+ * than the tuning table says are handled by summing Lagrange basis
+ * polynomials; by default, there are none, since that is less accurate, and
+ * the autotuner only finds such a threshold if it is also faster and no less
+ * accurate on this machine. Otherwise, the Newton form is used: equispaced
+ * nodes need only
+ * forward differences, arbitrary nodes are handled by the Björck–Pereyra
+ * algorithm, and the nodes are taken in Leja order whenever that is required
+ * to keep the divided differences bounded.
+ *
+ * @param num_of_points
+ * @param nodes Structure of the x-coordinates.
+ * @param precision
+ *
+ * @return Construction algorithm.
+ *****************************************************************************/
+Construction select_construction(std::size_t num_of_points, Nodes nodes, Precision precision)
+{
+    if(num_of_points < tuning().newton_min_points)
+    {
+        return Construction::lagrange;
+    }
+    switch(nodes)
+    {
+        case Nodes::equispaced:
+            return Construction::forward_difference;
+        case Nodes::chebyshev:
+            return Construction::newton_leja;
+        case Nodes::arbitrary:
+            break;
+    }
+    if(precision == Precision::high)
+    {
+        return Construction::newton_leja;
+    }
+    return Construction::bjorck_pereyra;
+}
+
+/******************************************************************************
+ * Choose an algorithm to multiply two polynomials.
+ *
+ * @param p_size Number of coefficients of the first polynomial.
+ * @param q_size Number of coefficients of the second polynomial.
+ *
+ * @return Multiplication algorithm.
+ *****************************************************************************/
+Multiplication select_multiplication(std::size_t p_size, std::size_t q_size)
+{
+    if(std::min(p_size, q_size) < std::max<std::size_t>(tuning().karatsuba_min_size, 2))
+    {
+        return Multiplication::schoolbook;
+    }
+    return Multiplication::karatsuba;
+}
+
+/******************************************************************************
+ * Obtain how the running time of a construction algorithm grows with the
+ * number of points, ignoring constant factors. The Lagrange algorithm
+ * multiplies out a product of linear factors for every point, which takes
+ * cubic time; the others take quadratic time.
+ *
+ * @param num_of_points
+ * @param construction
+ *
+ * @return Growth term.
+ *****************************************************************************/
+double cost_growth(std::size_t num_of_points, Construction construction)
+{
+    double n = num_of_points;
+    if(construction == Construction::lagrange)
+    {
+        return n * n * n;
+    }
+    return n * n;
+}
+
+/******************************************************************************
+ * Obtain the coefficient of the growth term of a construction algorithm.
+ *
+ * @param table Tuning table.
+ * @param construction
+ *
+ * @return Number of seconds per unit of the growth term.
+ *****************************************************************************/
+double& cost_coefficient(Tuning& table, Construction construction)
+{
+    switch(construction)
+    {
+        case Construction::lagrange:
+            return table.cost_lagrange;
+        case Construction::newton:
+            return table.cost_newton;
+        case Construction::newton_leja:
+            return table.cost_newton_leja;
+        case Construction::forward_difference:
+            return table.cost_forward_difference;
+        case Construction::bjorck_pereyra:
+            break;
+    }
+    return table.cost_bjorck_pereyra;
+}
+
+/******************************************************************************
+ * Predict how long it takes to construct an interpolating polynomial and
+ * evaluate it. The coefficients of the model are calibrated by running the
+ * benchmark with `--calibrate`.
+ *
+ * @param num_of_points
+ * @param construction
+ * @param num_of_queries Number of points to evaluate the polynomial at.
+ *
+ * @return Number of seconds.
+ *****************************************************************************/
+double predict_cost(std::size_t num_of_points, Construction construction, std::size_t num_of_queries)
+{
+    Tuning& table = tuning();
+    return table.cost_overhead + cost_coefficient(table, construction) * cost_growth(num_of_points, construction)
+           + table.cost_evaluation * num_of_points * num_of_queries;
+}
+
+/******************************************************************************
+ * Predict how long it takes to construct an interpolating polynomial and
+ * evaluate it using some arithmetic. With double-double numbers, the Newton
+ * form of the points in Leja order is found, and rounded to `double` before
+ * it is evaluated. With `BigFloat` numbers, it is found in the order given,
+ * and also evaluated using them; an operation takes longer the more bits they
+ * have, but mostly because of its overhead. With `Fraction`s, the polynomial
+ * is also constructed using `double`s to evaluate it, and the sizes of the
+ * numerators and denominators grow with the number of points, so that the
+ * time taken grows with about its sixth power.
+ *
+ * @param num_of_points
+ * @param construction Algorithm used with `double`s.
+ * @param arithmetic
+ * @param precision Number of bits of the `BigFloat` numbers.
+ * @param num_of_queries Number of points to evaluate the polynomial at.
+ *
+ * @return Number of seconds.
+ *****************************************************************************/
+double predict_cost(std::size_t num_of_points, Construction construction, Arithmetic arithmetic,
+                    std::size_t precision, std::size_t num_of_queries)
+{
+    Tuning& table = tuning();
+    double n = num_of_points;
+    switch(arithmetic)
+    {
+        case Arithmetic::standard:
+            break;
+        case Arithmetic::double_double:
+            return table.cost_overhead + table.cost_double_double * n * n
+                   + table.cost_evaluation * num_of_points * num_of_queries;
+        case Arithmetic::big_float:
+            return table.cost_overhead
+                   + table.cost_big_float * (1 + precision / 1024.0) * n * (n + num_of_queries);
+        case Arithmetic::rational:
+            return predict_cost(num_of_points, construction, num_of_queries)
+                   + table.cost_rational * std::pow(n, 6);
+    }
+    return predict_cost(num_of_points, construction, num_of_queries);
+}
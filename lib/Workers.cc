@@ -0,0 +1,401 @@
+#include <cerrno>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "Workers.hh"
+
+/******************************************************************************
+ * Read exactly the requested number of bytes from a blocking file descriptor.
+ *
+ * @param fd
+ * @param buffer
+ * @param count
+ *
+ * @return `true` if they were read, `false` if the end of the file was reached
+ *     or an error occurred first.
+ *****************************************************************************/
+static bool read_exactly(int fd, void* buffer, std::size_t count)
+{
+    char* position = static_cast<char*>(buffer);
+    while(count > 0)
+    {
+        ssize_t num_of_bytes = read(fd, position, count);
+        if(num_of_bytes == -1 && errno == EINTR)
+        {
+            continue;
+        }
+        if(num_of_bytes <= 0)
+        {
+            return false;
+        }
+        position += num_of_bytes;
+        count -= num_of_bytes;
+    }
+    return true;
+}
+
+/******************************************************************************
+ * Write exactly the requested number of bytes to a blocking file descriptor.
+ *
+ * @param fd
+ * @param buffer
+ * @param count
+ *
+ * @return `true` if they were written, `false` if an error occurred first.
+ *****************************************************************************/
+static bool write_exactly(int fd, void const* buffer, std::size_t count)
+{
+    char const* position = static_cast<char const*>(buffer);
+    while(count > 0)
+    {
+        ssize_t num_of_bytes = write(fd, position, count);
+        if(num_of_bytes == -1 && errno == EINTR)
+        {
+            continue;
+        }
+        if(num_of_bytes <= 0)
+        {
+            return false;
+        }
+        position += num_of_bytes;
+        count -= num_of_bytes;
+    }
+    return true;
+}
+
+/******************************************************************************
+ * Constructor. Fork the worker processes. No other threads may be running,
+ * since only this one would survive in the workers.
+ *
+ * @param num_of_workers
+ * @param handler Function which each worker calls to carry out a task. It
+ *     writes the output, the error messages and anything else to send back to
+ *     the strings provided, and returns an exit status.
+ * @param depth Number of tasks each worker may be given at a time.
+ *****************************************************************************/
+Workers::Workers(std::size_t num_of_workers, Handler handler, std::size_t depth)
+: handler(std::move(handler)), depth(depth == 0 ? 1 : depth), workers(num_of_workers == 0 ? 1 : num_of_workers),
+  num_of_restarts(0)
+{
+    // A worker which dies while a task is being sent to it must not take
+    // this process with it.
+    std::signal(SIGPIPE, SIG_IGN);
+    for(auto& worker: this->workers)
+    {
+        this->spawn(worker);
+    }
+}
+
+/******************************************************************************
+ * Destructor. Tell the workers to exit, and wait for them to do so.
+ *****************************************************************************/
+Workers::~Workers()
+{
+    for(auto& worker: this->workers)
+    {
+        close(worker.to);
+        close(worker.from);
+    }
+    for(auto& worker: this->workers)
+    {
+        waitpid(worker.pid, nullptr, 0);
+    }
+}
+
+/******************************************************************************
+ * Fork a worker process.
+ *
+ * @param worker Object to store its process ID and the ends of its pipes in.
+ *****************************************************************************/
+void Workers::spawn(Worker& worker)
+{
+    int request[2], response[2];
+    if(pipe(request) == -1)
+    {
+        throw std::system_error(errno, std::generic_category(), "Could not create a pipe");
+    }
+    if(pipe(response) == -1)
+    {
+        int error = errno;
+        close(request[0]);
+        close(request[1]);
+        throw std::system_error(error, std::generic_category(), "Could not create a pipe");
+    }
+    pid_t pid = fork();
+    if(pid == -1)
+    {
+        int error = errno;
+        close(request[0]);
+        close(request[1]);
+        close(response[0]);
+        close(response[1]);
+        throw std::system_error(error, std::generic_category(), "Could not create a worker process");
+    }
+    if(pid == 0)
+    {
+        // The pipes of the other workers must be closed here, or they would
+        // not see the end of their input when this process is told to exit.
+        close(request[1]);
+        close(response[0]);
+        for(auto const& other: this->workers)
+        {
+            if(other.to != -1)
+            {
+                close(other.to);
+                close(other.from);
+            }
+        }
+
+        // Leave without running destructors or flushing the output buffers
+        // inherited from the parent process.
+        this->serve(request[0], response[1]);
+        _exit(EXIT_SUCCESS);
+    }
+    close(request[0]);
+    close(response[1]);
+    fcntl(request[1], F_SETFL, fcntl(request[1], F_GETFL) | O_NONBLOCK);
+    fcntl(response[0], F_SETFL, fcntl(response[0], F_GETFL) | O_NONBLOCK);
+    worker.pid = pid;
+    worker.to = request[1];
+    worker.from = response[0];
+}
+
+/******************************************************************************
+ * Carry out tasks until there are no more. (Worker.) Each task arrives as its
+ * length followed by its contents; each outcome leaves as the exit status and
+ * the lengths of the output, the error messages and the report, followed by
+ * them.
+ *
+ * @param in File descriptor to read tasks from.
+ * @param out File descriptor to write outcomes to.
+ *****************************************************************************/
+void Workers::serve(int in, int out)
+{
+    std::string task, output, errors, report;
+    std::uint64_t length;
+    while(read_exactly(in, &length, sizeof length))
+    {
+        task.resize(length);
+        if(!read_exactly(in, &task[0], length))
+        {
+            return;
+        }
+        output.clear();
+        errors.clear();
+        report.clear();
+        std::int64_t status = this->handler(task, output, errors, report);
+        std::uint64_t header[] = {static_cast<std::uint64_t>(status), output.size(), errors.size(), report.size()};
+        if(!write_exactly(out, header, sizeof header) || !write_exactly(out, output.data(), output.size())
+           || !write_exactly(out, errors.data(), errors.size()) || !write_exactly(out, report.data(), report.size()))
+        {
+            return;
+        }
+    }
+}
+
+/******************************************************************************
+ * Submit a task. It is sent to a worker when one has room for it.
+ *
+ * @param index Number identifying the task, which its outcome will carry.
+ * @param task
+ *****************************************************************************/
+void Workers::submit(std::size_t index, std::string&& task)
+{
+    this->tasks[index].payload = std::move(task);
+    this->queued.push_back(index);
+    this->dispatch();
+}
+
+/******************************************************************************
+ * @return Number of tasks submitted whose outcomes have not been collected.
+ *****************************************************************************/
+std::size_t Workers::backlog(void) const
+{
+    return this->tasks.size();
+}
+
+/******************************************************************************
+ * @return Number of workers which died and were replaced.
+ *****************************************************************************/
+std::size_t Workers::restarts(void) const
+{
+    return this->num_of_restarts;
+}
+
+/******************************************************************************
+ * Give queued tasks to the workers which have room for them.
+ *****************************************************************************/
+void Workers::dispatch(void)
+{
+    for(auto& worker: this->workers)
+    {
+        while(worker.outstanding.size() < this->depth && !this->queued.empty())
+        {
+            std::size_t index = this->queued.front();
+            this->queued.pop_front();
+            std::string const& payload = this->tasks[index].payload;
+            std::uint64_t length = payload.size();
+            worker.outgoing.append(reinterpret_cast<char const*>(&length), sizeof length);
+            worker.outgoing.append(payload);
+            worker.outstanding.push_back(index);
+        }
+    }
+}
+
+/******************************************************************************
+ * Replace a worker which died. Its unfinished tasks are queued again, ahead of
+ * the others, except that the one it was carrying out is given up if it has
+ * already seen another worker die. Other threads may have been started since
+ * the constructor ran; the replacement must not need anything they may have
+ * locked.
+ *
+ * @param worker
+ * @param finished Outcomes of the tasks given up are appended to this.
+ *****************************************************************************/
+void Workers::replace(Worker& worker, std::vector<Outcome>& finished)
+{
+    close(worker.to);
+    close(worker.from);
+    int status = 0;
+    waitpid(worker.pid, &status, 0);
+    if(!worker.outstanding.empty())
+    {
+        std::size_t index = worker.outstanding.front();
+        if(++this->tasks[index].attempts >= 2)
+        {
+            std::string cause = WIFSIGNALED(status) ? "killed by signal " + std::to_string(WTERMSIG(status))
+                                                    : "exited with status " + std::to_string(WEXITSTATUS(status));
+            finished.push_back({index, EXIT_FAILURE, "", "The last worker process was " + cause + ".\n", "", true});
+            this->tasks.erase(index);
+            worker.outstanding.pop_front();
+        }
+        this->queued.insert(this->queued.begin(), worker.outstanding.begin(), worker.outstanding.end());
+    }
+    worker = Worker();
+    ++this->num_of_restarts;
+    this->spawn(worker);
+}
+
+/******************************************************************************
+ * Read what a worker has written, and extract the complete outcomes from it.
+ * If the worker has died, replace it.
+ *
+ * @param worker
+ * @param finished Outcomes extracted are appended to this.
+ *****************************************************************************/
+void Workers::receive(Worker& worker, std::vector<Outcome>& finished)
+{
+    bool dead = false;
+    char buffer[65536];
+    while(true)
+    {
+        ssize_t num_of_bytes = read(worker.from, buffer, sizeof buffer);
+        if(num_of_bytes > 0)
+        {
+            worker.incoming.append(buffer, num_of_bytes);
+            continue;
+        }
+        if(num_of_bytes == -1 && errno == EINTR)
+        {
+            continue;
+        }
+        dead = num_of_bytes == 0 || errno != EAGAIN;
+        break;
+    }
+
+    std::size_t position = 0;
+    std::uint64_t header[4];
+    while(worker.incoming.size() - position >= sizeof header)
+    {
+        std::memcpy(header, worker.incoming.data() + position, sizeof header);
+        std::size_t length = sizeof header + header[1] + header[2] + header[3];
+        if(worker.incoming.size() - position < length)
+        {
+            break;
+        }
+        char const* output = worker.incoming.data() + position + sizeof header;
+        std::size_t index = worker.outstanding.front();
+        worker.outstanding.pop_front();
+        this->tasks.erase(index);
+        finished.push_back({index, static_cast<int>(static_cast<std::int64_t>(header[0])),
+                            std::string(output, header[1]), std::string(output + header[1], header[2]),
+                            std::string(output + header[1] + header[2], header[3]), false});
+        position += length;
+    }
+    worker.incoming.erase(0, position);
+    if(dead)
+    {
+        this->replace(worker, finished);
+    }
+}
+
+/******************************************************************************
+ * Wait until at least one outcome is available, unless there are no tasks
+ * left.
+ *
+ * @param finished Outcomes are appended to this, in no particular order.
+ *****************************************************************************/
+void Workers::collect(std::vector<Outcome>& finished)
+{
+    std::vector<pollfd> fds(2 * this->workers.size());
+    std::size_t count = finished.size();
+    while(finished.size() == count && !this->tasks.empty())
+    {
+        this->dispatch();
+        for(std::size_t i = 0; i < this->workers.size(); ++i)
+        {
+            Worker const& worker = this->workers[i];
+            fds[2 * i] = {worker.from, POLLIN, 0};
+            fds[2 * i + 1] = {worker.to, static_cast<short>(worker.sent < worker.outgoing.size() ? POLLOUT : 0), 0};
+        }
+        if(poll(fds.data(), fds.size(), -1) == -1)
+        {
+            if(errno == EINTR)
+            {
+                continue;
+            }
+            throw std::system_error(errno, std::generic_category(), "Could not wait for the worker processes");
+        }
+        for(std::size_t i = 0; i < this->workers.size(); ++i)
+        {
+            Worker& worker = this->workers[i];
+            if(fds[2 * i + 1].revents != 0 && worker.sent < worker.outgoing.size())
+            {
+                ssize_t num_of_bytes = write(worker.to, worker.outgoing.data() + worker.sent,
+                                             worker.outgoing.size() - worker.sent);
+                if(num_of_bytes > 0)
+                {
+                    worker.sent += num_of_bytes;
+                    if(worker.sent == worker.outgoing.size())
+                    {
+                        worker.outgoing.clear();
+                        worker.sent = 0;
+                    }
+                }
+                else if(errno != EAGAIN && errno != EINTR)
+                {
+                    // It has died. Collect what it finished before that.
+                    this->receive(worker, finished);
+                    continue;
+                }
+            }
+            if(fds[2 * i].revents != 0)
+            {
+                this->receive(worker, finished);
+            }
+        }
+    }
+}
@@ -0,0 +1,136 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Measure.hh"
+#include "Polynomial.hh"
+#include "Tuning.hh"
+
+/******************************************************************************
+ * Generate x-coordinates belonging to a standard family of nodes.
+ *
+ * @param family Name of the family.
+ * @param num_of_points
+ * @param generator Random number generator.
+ *
+ * @return x-coordinates.
+ *****************************************************************************/
+static std::vector<double> nodes(std::string const& family, std::size_t num_of_points, std::mt19937& generator)
+{
+    double const pi = std::acos(-1.0);
+    std::vector<double> xcoords;
+    std::uniform_real_distribution<double> distribution(-1, 1);
+    for(std::size_t i = 0; i < num_of_points; ++i)
+    {
+        if(family == "integers")
+        {
+            xcoords.push_back(i + 1.0);
+        }
+        else if(family == "equispaced")
+        {
+            xcoords.push_back(-1 + 2.0 * i / (num_of_points - 1));
+        }
+        else if(family == "chebyshev")
+        {
+            xcoords.push_back(std::cos((2 * i + 1) * pi / (2 * num_of_points)));
+        }
+        else
+        {
+            xcoords.push_back(distribution(generator));
+        }
+    }
+    if(family == "random")
+    {
+        std::sort(xcoords.begin(), xcoords.end());
+    }
+    return xcoords;
+}
+
+/******************************************************************************
+ * Main function. For each family of nodes and number of points, interpolate a
+ * polynomial with known random coefficients using each construction
+ * algorithm, and display the time taken, the largest error in the
+ * coefficients (relative to the largest coefficient) and the largest residual
+ * at the nodes (relative to the largest y-coordinate).
+ *****************************************************************************/
+int main(void)
+{
+    std::mt19937 generator(81);
+    std::uniform_real_distribution<double> distribution(-1, 1);
+    struct Algorithm
+    {
+        char const* name;
+        Construction construction;
+    };
+    std::vector<Algorithm> algorithms =
+    {
+        {"Lagrange", Construction::lagrange},
+        {"Newton", Construction::newton},
+        {"Newton (Leja)", Construction::newton_leja},
+        {"forward difference", Construction::forward_difference},
+        {"Björck–Pereyra", Construction::bjorck_pereyra},
+    };
+
+    std::cout << std::setprecision(3);
+    std::cout << "nodes, points, algorithm, time (µs), coefficient error, residual\n";
+    for(std::string family: {"integers", "equispaced", "chebyshev", "random"})
+    {
+        for(std::size_t num_of_points: {8, 16, 24, 32})
+        {
+            std::vector<double> xcoords = nodes(family, num_of_points, generator);
+            std::vector<double> coefficients(num_of_points);
+            double largest_coefficient = 0;
+            for(auto& coefficient: coefficients)
+            {
+                coefficient = distribution(generator);
+                largest_coefficient = std::max(largest_coefficient, std::abs(coefficient));
+            }
+
+            // Compute the y-coordinates in extended precision, so that they
+            // are as close to exact as possible.
+            std::vector<double> ycoords;
+            double largest_ycoord = 0;
+            for(auto const& xcoord: xcoords)
+            {
+                long double ycoord = 0;
+                for(auto it = coefficients.crbegin(); it != coefficients.crend(); ++it)
+                {
+                    ycoord = ycoord * xcoord + *it;
+                }
+                ycoords.push_back(ycoord);
+                largest_ycoord = std::max(largest_ycoord, std::abs(ycoords.back()));
+            }
+
+            for(auto const& algorithm: algorithms)
+            {
+                bool equispaced = (family == "integers" || family == "equispaced");
+                if(algorithm.construction == Construction::forward_difference && !equispaced)
+                {
+                    continue;
+                }
+                Polynomial p(xcoords, ycoords, algorithm.construction);
+                double time = measure([&]{ static_cast<void>(Polynomial(xcoords, ycoords, algorithm.construction)); });
+                double coefficient_error = 0;
+                for(std::size_t i = 0; i < num_of_points; ++i)
+                {
+                    double computed = i < p.size() ? p[i] : 0;
+                    coefficient_error = std::max(coefficient_error, std::abs(computed - coefficients[i]));
+                }
+                double residual = 0;
+                for(std::size_t i = 0; i < num_of_points; ++i)
+                {
+                    residual = std::max(residual, std::abs(p(xcoords[i]) - ycoords[i]));
+                }
+                std::cout << family << ", " << num_of_points << ", " << algorithm.name << ", " << time * 1e6 << ", "
+                          << coefficient_error / largest_coefficient << ", " << residual / largest_ycoord << "\n";
+            }
+        }
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "Measure.hh"
+#include "Polynomial.hh"
+#include "Tuning.hh"
+
+/******************************************************************************
+ * Find the crossover point of two algorithms.
+ *
+ * @param sizes Problem sizes, in increasing order.
+ * @param better Whether the second algorithm was preferable for each size.
+ * @param fallback Value to return if the second algorithm is never preferable.
+ *
+ * @return Smallest size from which onwards the second algorithm is preferable.
+ *****************************************************************************/
+static std::size_t crossover(std::vector<std::size_t> const& sizes, std::vector<bool> const& better,
+                             std::size_t fallback)
+{
+    std::size_t result = fallback;
+    for(std::size_t i = sizes.size(); i > 0 && better[i - 1]; --i)
+    {
+        result = sizes[i - 1];
+    }
+    return result;
+}
+
+/******************************************************************************
+ * Compare schoolbook multiplication with a single level of Karatsuba's
+ * algorithm.
+ *
+ * @param generator Random number generator.
+ *
+ * @return Smallest size at which Karatsuba's algorithm should be used.
+ *****************************************************************************/
+static std::size_t tune_multiplication(std::mt19937& generator)
+{
+    std::uniform_real_distribution<double> distribution(-1, 1);
+    std::vector<std::size_t> sizes = {4, 6, 8, 12, 16, 24, 32, 48, 64, 96, 128, 192, 256};
+    std::vector<bool> faster;
+    std::cout << "Multiplication (µs): size, schoolbook, Karatsuba\n";
+    for(auto const& size: sizes)
+    {
+        Polynomial p, q;
+        for(std::size_t i = 0; i < size; ++i)
+        {
+            p.push_back(distribution(generator));
+            q.push_back(distribution(generator));
+        }
+        tuning().karatsuba_min_size = std::numeric_limits<std::size_t>::max();
+        double schoolbook = measure([&]{ static_cast<void>(p * q); }, 5);
+        tuning().karatsuba_min_size = size;
+        double karatsuba = measure([&]{ static_cast<void>(p * q); }, 5);
+        faster.push_back(karatsuba < schoolbook);
+        std::cout << "  " << size << ", " << schoolbook * 1e6 << ", " << karatsuba * 1e6 << "\n";
+    }
+    return crossover(sizes, faster, 2 * sizes.back());
+}
+
+/******************************************************************************
+ * Compare summation of Lagrange basis polynomials with the Newton form
+ * (obtained using the Björck–Pereyra algorithm) on arbitrary nodes. The Newton
+ * form is preferred unless summation is both faster and at least as accurate
+ * (judged by the residuals at the points).
+ *
+ * @param generator Random number generator.
+ *
+ * @return Smallest number of points for which the Newton form should be used.
+ *****************************************************************************/
+static std::size_t tune_construction(std::mt19937& generator)
+{
+    std::uniform_real_distribution<double> distribution(0, 1);
+    std::vector<std::size_t> sizes;
+    std::vector<bool> better;
+    std::cout << "Construction (µs, residual): points, Lagrange, Newton\n";
+    for(std::size_t size = 3; size <= 40; ++size)
+    {
+        std::vector<double> xcoords, ycoords;
+        for(std::size_t i = 0; i < size; ++i)
+        {
+            xcoords.push_back(i + distribution(generator) / 2);
+            ycoords.push_back(distribution(generator));
+        }
+        tuning().newton_min_points = std::numeric_limits<std::size_t>::max();
+        double lagrange = measure([&]{ static_cast<void>(Polynomial(xcoords, ycoords)); }, 5);
+        double lagrange_residual = Polynomial(xcoords, ycoords).residual(xcoords, ycoords);
+        tuning().newton_min_points = 0;
+        double newton = measure([&]{ static_cast<void>(Polynomial(xcoords, ycoords)); }, 5);
+        double newton_residual = Polynomial(xcoords, ycoords).residual(xcoords, ycoords);
+        sizes.push_back(size);
+        better.push_back(newton < lagrange || newton_residual <= lagrange_residual);
+        std::cout << "  " << size << ", " << lagrange * 1e6 << " (" << lagrange_residual << "), " << newton * 1e6
+                  << " (" << newton_residual << ")\n";
+    }
+    return crossover(sizes, better, 2 * sizes.back());
+}
+
+/******************************************************************************
+ * Main function. Measure the crossover points of the algorithms on this
+ * machine, and write them to a tuning file.
+ *****************************************************************************/
+int main(int const argc, char const* argv[])
+{
+    if(argc < 2)
+    {
+        std::cerr << "Usage:\n";
+        std::cerr << "  " << argv[0] << " <tuning file>\n";
+        return EXIT_FAILURE;
+    }
+
+    // Start from the built-in defaults rather than from any earlier tuning
+    // file, so that the fields not measured here are reset.
+    Tuning measured;
+    std::mt19937 generator(42);
+    tuning() = measured;
+    measured.karatsuba_min_size = tune_multiplication(generator);
+    tuning() = measured;
+    measured.newton_min_points = tune_construction(generator);
+
+    std::cout << "karatsuba_min_size " << measured.karatsuba_min_size << "\n";
+    std::cout << "newton_min_points " << measured.newton_min_points << "\n";
+    if(!save_tuning(argv[1], measured))
+    {
+        std::cerr << "File " << argv[1] << " could not be written.\n";
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
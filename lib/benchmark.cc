@@ -0,0 +1,351 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "BigFloat.hh"
+#include "Fraction.hh"
+#include "Input.hh"
+#include "Measure.hh"
+#include "Polynomial.hh"
+#include "Tuning.hh"
+
+// Points read from a file in the input format of the main program.
+struct Workload
+{
+    std::string name;
+    std::vector<double> xcoords, ycoords;
+    double query;
+};
+
+/******************************************************************************
+ * Run every workload once: construct the interpolating polynomial with each
+ * precision, evaluate it and square it (which exercises multiplication).
+ *
+ * @param workloads
+ * @param times Time taken by each workload is added to this, in seconds.
+ *
+ * @return Sum of the results, so that none of the work may be optimised away.
+ *****************************************************************************/
+static double run(std::vector<Workload> const& workloads, std::vector<double>& times)
+{
+    double checksum = 0;
+    for(std::size_t i = 0; i < workloads.size(); ++i)
+    {
+        auto begin = std::chrono::steady_clock::now();
+        for(auto precision: {Precision::standard, Precision::high})
+        {
+            Polynomial p(workloads[i].xcoords, workloads[i].ycoords, precision);
+            checksum += p(workloads[i].query);
+            checksum += (p * p).size();
+        }
+        auto end = std::chrono::steady_clock::now();
+        times[i] += std::chrono::duration<double>(end - begin).count();
+    }
+    return checksum;
+}
+
+/******************************************************************************
+ * Find the interpolating polynomial passing through the points of a workload
+ * using some arithmetic other than `double`, as the main program does, and
+ * evaluate it at the query.
+ *
+ * @param workload
+ * @param arithmetic
+ * @param precision Number of bits of the `BigFloat` numbers.
+ *
+ * @return Value at the query, so that none of the work may be optimised away.
+ *****************************************************************************/
+static double run(Workload const& workload, Arithmetic arithmetic, std::size_t precision)
+{
+    if(arithmetic == Arithmetic::big_float)
+    {
+        std::vector<BigFloat> xcoords, ycoords;
+        for(std::size_t i = 0; i < workload.xcoords.size(); ++i)
+        {
+            xcoords.push_back(BigFloat(workload.xcoords[i], precision));
+            ycoords.push_back(BigFloat(workload.ycoords[i], precision));
+        }
+        return BasicPolynomial<BigFloat>(xcoords, ycoords)(BigFloat(workload.query, precision)).to_double();
+    }
+    if(arithmetic == Arithmetic::rational)
+    {
+        std::vector<Fraction> xcoords, ycoords;
+        for(std::size_t i = 0; i < workload.xcoords.size(); ++i)
+        {
+            xcoords.push_back(Fraction(workload.xcoords[i]));
+            ycoords.push_back(Fraction(workload.ycoords[i]));
+        }
+        BasicPolynomial<Fraction> exact(xcoords, ycoords);
+        return Polynomial(workload.xcoords, workload.ycoords)(workload.query) + exact.size();
+    }
+    return Polynomial(interpolate_extended(workload.xcoords, workload.ycoords))(workload.query);
+}
+
+/******************************************************************************
+ * Calibrate the cost model. For each construction algorithm, time it on every
+ * workload it applies to, and fit the overhead and the coefficient of the
+ * growth term (see `cost_growth`) by least squares on the relative error. The
+ * overhead used is the average of those fitted. Then time the evaluation of
+ * the polynomials at many points. Finally, fit the coefficient of each
+ * arithmetic other than `double` in the same way, to the time left over by the
+ * rest of the model.
+ *
+ * @param workloads
+ * @param path Tuning file to update with the fitted coefficients.
+ *
+ * @return `true` if the tuning file was written, else `false`.
+ *****************************************************************************/
+static bool calibrate(std::vector<Workload> const& workloads, char const* path)
+{
+    Tuning table = tuning();
+    double overhead = 0;
+    std::size_t num_of_fits = 0;
+    for(auto construction: {Construction::lagrange, Construction::newton, Construction::newton_leja,
+                            Construction::forward_difference, Construction::bjorck_pereyra})
+    {
+        // Sums of the weights, and of the weighted growth terms and times and
+        // their products. Each time is weighted by its inverse square.
+        double s = 0, sg = 0, sgg = 0, st = 0, sgt = 0;
+        for(auto const& workload: workloads)
+        {
+            std::size_t num_of_points = workload.xcoords.size();
+            bool equispaced = classify(workload.xcoords, num_of_points) == Nodes::equispaced;
+            if(num_of_points < 2 || (construction == Construction::forward_difference && !equispaced))
+            {
+                continue;
+            }
+            double time = measure([&]{ static_cast<void>(Polynomial(workload.xcoords, workload.ycoords,
+                                                                     construction)); });
+            double growth = cost_growth(num_of_points, construction);
+            double weight = 1 / (time * time);
+            s += weight;
+            sg += weight * growth;
+            sgg += weight * growth * growth;
+            st += weight * time;
+            sgt += weight * growth * time;
+        }
+        if(s == 0)
+        {
+            continue;
+        }
+        double determinant = s * sgg - sg * sg;
+        double coefficient = determinant > 0 ? (s * sgt - sg * st) / determinant : 0;
+        double intercept = (st - coefficient * sg) / s;
+        if(intercept < 0 || coefficient <= 0)
+        {
+            intercept = 0;
+            coefficient = sgt / sgg;
+        }
+        cost_coefficient(table, construction) = coefficient;
+        overhead += intercept;
+        ++num_of_fits;
+    }
+    table.cost_overhead = num_of_fits > 0 ? overhead / num_of_fits : table.cost_overhead;
+
+    double evaluation_time = 0, evaluation_work = 0;
+    for(auto const& workload: workloads)
+    {
+        Polynomial p(workload.xcoords, workload.ycoords);
+        std::vector<double> xcoords(1024, workload.query), ycoords(xcoords.size());
+        evaluation_time += measure([&]{ p.evaluate(xcoords.data(), ycoords.data(), xcoords.size()); });
+        evaluation_work += static_cast<double>(p.size()) * xcoords.size();
+    }
+    if(evaluation_work > 0)
+    {
+        table.cost_evaluation = evaluation_time / evaluation_work;
+    }
+
+    // The model is linear in each of these coefficients, so the term one
+    // multiplies is found by predicting with it set to 0 and to 1. Workloads
+    // predicted to take longer than a limit are not measured: the time taken
+    // with `Fraction`s grows with about the sixth power of the number of
+    // points. It also grows with the number of bits in the coordinates, and
+    // the model assumes they use all 53 (equispaced x-coordinates are usually
+    // small integers, which are far cheaper).
+    std::size_t const precision = 128;
+    double const limit = 1;
+    std::pair<Arithmetic, double Tuning::*> const coefficients[] =
+    {
+        {Arithmetic::double_double, &Tuning::cost_double_double},
+        {Arithmetic::big_float, &Tuning::cost_big_float},
+        {Arithmetic::rational, &Tuning::cost_rational},
+    };
+    tuning() = table;
+    for(auto const& [arithmetic, coefficient]: coefficients)
+    {
+        double sgg = 0, sgr = 0;
+        for(auto const& workload: workloads)
+        {
+            std::size_t num_of_points = workload.xcoords.size();
+            if(num_of_points < 2)
+            {
+                continue;
+            }
+            Nodes nodes = classify(workload.xcoords, num_of_points);
+            if(arithmetic == Arithmetic::rational && nodes == Nodes::equispaced)
+            {
+                continue;
+            }
+            Construction construction = select_construction(num_of_points, nodes, Precision::standard);
+            auto predict = [&](double value)
+            {
+                tuning().*coefficient = value;
+                return predict_cost(num_of_points, construction, arithmetic, precision, 1);
+            };
+            double rest = predict(0);
+            double growth = predict(1) - rest;
+            if(predict(table.*coefficient) > limit)
+            {
+                continue;
+            }
+            double time = measure([&]{ static_cast<void>(run(workload, arithmetic, precision)); });
+            double weight = 1 / (time * time);
+            sgg += weight * growth * growth;
+            sgr += weight * growth * (time - rest);
+        }
+        if(sgg > 0 && sgr > 0)
+        {
+            table.*coefficient = sgr / sgg;
+        }
+        tuning() = table;
+    }
+
+    std::cout << "cost_overhead " << table.cost_overhead << "\n";
+    std::cout << "cost_lagrange " << table.cost_lagrange << "\n";
+    std::cout << "cost_newton " << table.cost_newton << "\n";
+    std::cout << "cost_newton_leja " << table.cost_newton_leja << "\n";
+    std::cout << "cost_forward_difference " << table.cost_forward_difference << "\n";
+    std::cout << "cost_bjorck_pereyra " << table.cost_bjorck_pereyra << "\n";
+    std::cout << "cost_evaluation " << table.cost_evaluation << "\n";
+    std::cout << "cost_double_double " << table.cost_double_double << "\n";
+    std::cout << "cost_big_float " << table.cost_big_float << "\n";
+    std::cout << "cost_rational " << table.cost_rational << "\n";
+    return save_tuning(path, table);
+}
+
+/******************************************************************************
+ * Main function. Time the construction of interpolating polynomials for the
+ * given input files. The total time on the last line of the output is what
+ * the profile-guided optimisation build compares. With `--calibrate`, fit the
+ * cost model to the input files instead.
+ *****************************************************************************/
+int main(int const argc, char const* argv[])
+{
+    char const* calibration_path = nullptr;
+    std::vector<char const*> paths;
+    for(int i = 1; i < argc; ++i)
+    {
+        if(std::string(argv[i]) == "--calibrate" && i + 1 < argc)
+        {
+            calibration_path = argv[++i];
+        }
+        else
+        {
+            paths.push_back(argv[i]);
+        }
+    }
+    if(paths.empty())
+    {
+        std::cerr << "Usage:\n";
+        std::cerr << "  " << argv[0] << " [--calibrate <tuning file>] <input file> [<input file> ...]\n";
+        return EXIT_FAILURE;
+    }
+    // Every set of points in a file is a workload. Each is evaluated at its
+    // first query, or at its last x-coordinate if it has none.
+    std::vector<Workload> workloads;
+    for(auto const& path: paths)
+    {
+        std::string contents;
+        if(!read_file(path, contents))
+        {
+            std::cerr << "File " << path << " could not be read.\n";
+            return EXIT_FAILURE;
+        }
+        Stream stream(std::move(contents));
+        char const* begin;
+        char const* end;
+        std::size_t first = workloads.size();
+        for(std::size_t set = 1; stream.next(begin, end); ++set)
+        {
+            Points points;
+            try
+            {
+                parse_points(begin, end, points);
+            }
+            catch(std::invalid_argument const& e)
+            {
+                std::cerr << "File " << path << ", set " << set << ": " << e.what() << "\n";
+                return EXIT_FAILURE;
+            }
+            if(points.xcoords.empty())
+            {
+                std::cerr << "File " << path << ", set " << set << " has no points.\n";
+                return EXIT_FAILURE;
+            }
+            Workload workload;
+            workload.name = path;
+            workload.query = points.queries.empty() ? points.xcoords.back() : points.queries.front();
+            workload.xcoords = std::move(points.xcoords);
+            workload.ycoords = std::move(points.ycoords);
+            workloads.push_back(std::move(workload));
+        }
+        if(workloads.size() == first)
+        {
+            std::cerr << "File " << path << " has no points.\n";
+            return EXIT_FAILURE;
+        }
+        if(workloads.size() - first > 1)
+        {
+            for(std::size_t i = first; i < workloads.size(); ++i)
+            {
+                workloads[i].name += ", set " + std::to_string(i - first + 1);
+            }
+        }
+    }
+
+    if(calibration_path != nullptr)
+    {
+        if(!calibrate(workloads, calibration_path))
+        {
+            std::cerr << "File " << calibration_path << " could not be written.\n";
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+
+    // Take the best of several trials, each of which runs every workload a
+    // fixed number of times.
+    int const trials = 5;
+    int const repetitions = 20;
+    std::vector<double> best(workloads.size(), std::numeric_limits<double>::infinity());
+    double checksum = 0;
+    for(int trial = 0; trial < trials; ++trial)
+    {
+        std::vector<double> times(workloads.size(), 0);
+        for(int repetition = 0; repetition < repetitions; ++repetition)
+        {
+            checksum += run(workloads, times);
+        }
+        for(std::size_t i = 0; i < workloads.size(); ++i)
+        {
+            best[i] = std::min(best[i], times[i] / repetitions);
+        }
+    }
+
+    double total = 0;
+    for(std::size_t i = 0; i < workloads.size(); ++i)
+    {
+        std::cout << workloads[i].name << ": " << best[i] * 1e6 << " µs\n";
+        total += best[i];
+    }
+    std::cout << "Checksum: " << checksum << "\n";
+    std::cout << "Total: " << total * 1e6 << " µs\n";
+    return EXIT_SUCCESS;
+}
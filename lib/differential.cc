@@ -0,0 +1,518 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Barycentric.hh"
+#include "Batch.hh"
+#include "BasicPolynomial.hh"
+#include "BigFloat.hh"
+#include "Input.hh"
+#include "Measure.hh"
+#include "Polynomial.hh"
+#include "Rational.hh"
+#include "Tuning.hh"
+
+// Set of points read from a file in the input format of the main program.
+struct Workload
+{
+    std::string name;
+    std::size_t set = 0;
+    std::vector<double> xcoords, ycoords, queries;
+};
+
+// Engine which interpolates a set of points. It finds the coefficients (left
+// empty if it does not) and the values at the queries. Its errors in a set of
+// n points may be at most `tolerance + tolerance_per_point * n` times the
+// bound on the error caused by rounding the data (see `Bounds`).
+struct Engine
+{
+    char const* name;
+    double tolerance, tolerance_per_point;
+    std::function<bool(Workload const&)> applies;
+    std::function<void(Workload const&, std::vector<double>&, std::vector<double>&)> run;
+};
+
+// Worst errors and total time of an engine over the workloads.
+struct Summary
+{
+    std::size_t num_of_sets = 0;
+    double time = 0;
+    bool has_coefficients = false, has_predictions = false;
+    double coefficient_ulps = 0, coefficient_error = 0;
+    double prediction_ulps = 0, prediction_error = 0;
+    double excess = 0;
+};
+
+// Bounds on the errors which perturbing each y-coordinate of a set of points
+// by at most a unit roundoff relative to itself can cause: in each
+// coefficient, and in the value at each query, computed either from the
+// coefficients or from the Lagrange form.
+struct Bounds
+{
+    std::vector<double> coefficients, monomial, lagrange;
+};
+
+/******************************************************************************
+ * Find the error of a computed number in units in the last place of the exact
+ * number, rounded to the nearest floating-point number.
+ *
+ * @param computed
+ * @param exact
+ *
+ * @return Error, in units in the last place.
+ *****************************************************************************/
+static double ulps(double computed, Rational const& exact)
+{
+    if(!std::isfinite(computed))
+    {
+        return std::numeric_limits<double>::infinity();
+    }
+    double nearest = std::abs(exact.to_double());
+    double ulp = std::nextafter(nearest, std::numeric_limits<double>::infinity()) - nearest;
+    return std::abs((Rational(computed) - exact).to_double()) / ulp;
+}
+
+/******************************************************************************
+ * Bound the errors which rounding the y-coordinates of a set of points can
+ * cause. The coefficients of the Lagrange basis polynomials are bounded by
+ * those of the products of `x + |x_j|` (which involve no cancellation), so
+ * that everything computed here is accurate to a few units in the last place.
+ *
+ * @param workload
+ *
+ * @return Bounds.
+ *****************************************************************************/
+static Bounds bound(Workload const& workload)
+{
+    std::vector<double> const& xcoords = workload.xcoords;
+    std::vector<double> const& ycoords = workload.ycoords;
+    std::size_t num_of_points = xcoords.size();
+    double unit_roundoff = std::numeric_limits<double>::epsilon() / 2;
+    Bounds bounds;
+    bounds.coefficients.assign(num_of_points, 0);
+    bounds.lagrange.assign(workload.queries.size(), 0);
+    std::vector<double> basis;
+    for(std::size_t i = 0; i < num_of_points; ++i)
+    {
+        basis.assign(1, std::abs(ycoords[i]) * unit_roundoff);
+        for(std::size_t j = 0; j < num_of_points; ++j)
+        {
+            if(i == j)
+            {
+                continue;
+            }
+            double difference = std::abs(xcoords[i] - xcoords[j]);
+            basis.push_back(0);
+            for(std::size_t k = basis.size() - 1; k > 0; --k)
+            {
+                basis[k] = (basis[k - 1] + std::abs(xcoords[j]) * basis[k]) / difference;
+            }
+            basis[0] = std::abs(xcoords[j]) * basis[0] / difference;
+        }
+        for(std::size_t k = 0; k < num_of_points; ++k)
+        {
+            bounds.coefficients[k] += basis[k];
+        }
+        for(std::size_t q = 0; q < workload.queries.size(); ++q)
+        {
+            double term = std::abs(ycoords[i]) * unit_roundoff;
+            for(std::size_t j = 0; j < num_of_points; ++j)
+            {
+                if(i != j)
+                {
+                    term *= std::abs((workload.queries[q] - xcoords[j]) / (xcoords[i] - xcoords[j]));
+                }
+            }
+            bounds.lagrange[q] += term;
+        }
+    }
+    for(double query: workload.queries)
+    {
+        double sum = 0;
+        for(auto it = bounds.coefficients.rbegin(); it != bounds.coefficients.rend(); ++it)
+        {
+            sum = sum * std::abs(query) + *it;
+        }
+        bounds.monomial.push_back(sum);
+    }
+    return bounds;
+}
+
+/******************************************************************************
+ * @return Engines which interpolate sets of points: each algorithm which
+ *     constructs `Polynomial`, the SIMD batch functions (for small sets),
+ *     iterative refinement, construction in double-double arithmetic,
+ *     Newton's divided differences with 128-bit coefficients and the
+ *     barycentric form (which does not find coefficients). The tolerances
+ *     are the known bounds on the errors of the algorithms, as multiples of
+ *     the bounds on the errors caused by rounding the data (Higham, Accuracy
+ *     and Stability of Numerical Algorithms): 5n for the coefficients found
+ *     by divided differences or by multiplying out linear factors, and 2n
+ *     more for evaluating them using Horner's method; 3n + 4 for the second
+ *     barycentric formula; and, for the coefficients found more precisely,
+ *     1 for rounding them (and 2n for evaluating them, unless that is done
+ *     more precisely too).
+ *****************************************************************************/
+static std::vector<Engine> engines(void)
+{
+    auto always = [](Workload const&){ return true; };
+    auto evaluate = [](auto const& p, Workload const& workload, std::vector<double>& predictions)
+    {
+        predictions.clear();
+        for(double query: workload.queries)
+        {
+            predictions.push_back(p(query));
+        }
+    };
+    auto construct = [evaluate](Construction construction)
+    {
+        return [construction, evaluate](Workload const& workload, std::vector<double>& coefficients,
+                                        std::vector<double>& predictions)
+        {
+            Polynomial p(workload.xcoords, workload.ycoords, construction);
+            coefficients.assign(p.begin(), p.end());
+            evaluate(p, workload, predictions);
+        };
+    };
+    return
+    {
+        {"Lagrange", 0, 7, always, construct(Construction::lagrange)},
+        {"Newton", 0, 7, always, construct(Construction::newton)},
+        {"Newton (Leja)", 0, 7, always, construct(Construction::newton_leja)},
+        {"forward difference", 0, 7,
+         [](Workload const& workload)
+         {
+             return classify(workload.xcoords, workload.xcoords.size()) == Nodes::equispaced;
+         },
+         construct(Construction::forward_difference)},
+        {"Björck–Pereyra", 0, 7, always, construct(Construction::bjorck_pereyra)},
+        {"SIMD batch", 0, 7,
+         [](Workload const& workload){ return workload.xcoords.size() <= batch_max_points; },
+         [](Workload const& workload, std::vector<double>& coefficients, std::vector<double>& predictions)
+         {
+             // The values come from the Newton form, as they would in a
+             // batch.
+             std::size_t num_of_points = workload.xcoords.size();
+             double newton[batch_max_points];
+             coefficients.resize(num_of_points);
+             batch_monomial(1, nullptr, num_of_points, workload.xcoords.data(), workload.ycoords.data(),
+                            coefficients.data());
+             batch_newton(1, nullptr, num_of_points, workload.xcoords.data(), workload.ycoords.data(), newton);
+             predictions.resize(workload.queries.size());
+             for(std::size_t i = 0; i < workload.queries.size(); ++i)
+             {
+                 batch_evaluate(1, nullptr, num_of_points, workload.xcoords.data(), newton, &workload.queries[i],
+                                &predictions[i]);
+             }
+         }},
+        {"refined", 0, 7, always,
+         [evaluate](Workload const& workload, std::vector<double>& coefficients, std::vector<double>& predictions)
+         {
+             Polynomial p(workload.xcoords, workload.ycoords);
+             p.refine(workload.xcoords, workload.ycoords);
+             coefficients.assign(p.begin(), p.end());
+             evaluate(p, workload, predictions);
+         }},
+        {"double-double", 1, 2, always,
+         [evaluate](Workload const& workload, std::vector<double>& coefficients, std::vector<double>& predictions)
+         {
+             Polynomial p(workload.xcoords, workload.ycoords, Precision::extended);
+             coefficients.assign(p.begin(), p.end());
+             evaluate(p, workload, predictions);
+         }},
+        {"BigFloat (128 bits)", 1, 0, always,
+         [](Workload const& workload, std::vector<double>& coefficients, std::vector<double>& predictions)
+         {
+             std::vector<BigFloat> xcoords, ycoords;
+             for(std::size_t i = 0; i < workload.xcoords.size(); ++i)
+             {
+                 xcoords.push_back(BigFloat(workload.xcoords[i], 128));
+                 ycoords.push_back(BigFloat(workload.ycoords[i], 128));
+             }
+             BasicPolynomial<BigFloat> p(xcoords, ycoords);
+             coefficients.clear();
+             for(auto const& coefficient: p)
+             {
+                 coefficients.push_back(coefficient.to_double());
+             }
+             predictions.clear();
+             for(double query: workload.queries)
+             {
+                 predictions.push_back(p(BigFloat(query, 128)).to_double());
+             }
+         }},
+        {"barycentric", 4, 3, always,
+         [evaluate](Workload const& workload, std::vector<double>& coefficients, std::vector<double>& predictions)
+         {
+             coefficients.clear();
+             evaluate(Barycentric(workload.xcoords, workload.ycoords), workload, predictions);
+         }},
+    };
+}
+
+/******************************************************************************
+ * Describe the tolerance of an engine.
+ *
+ * @param engine
+ *
+ * @return Tolerance, in terms of the number of points n.
+ *****************************************************************************/
+static std::string describe_tolerance(Engine const& engine)
+{
+    std::ostringstream out;
+    if(engine.tolerance_per_point != 0)
+    {
+        out << engine.tolerance_per_point << "n";
+        if(engine.tolerance != 0)
+        {
+            out << " + ";
+        }
+    }
+    if(engine.tolerance != 0 || engine.tolerance_per_point == 0)
+    {
+        out << engine.tolerance;
+    }
+    return out.str();
+}
+
+/******************************************************************************
+ * Run every engine which applies to a workload, compare its results with the
+ * exact ones, and display its time and errors. Coefficient errors are the
+ * largest over the coefficients; relative ones are relative to the largest
+ * exact coefficient. Prediction errors are the largest over the queries. The
+ * excess is the largest ratio of an error to its bound (see `bound`); errors
+ * in the values found from the coefficients are bounded allowing for the
+ * coefficients having been perturbed.
+ *
+ * @param workload
+ * @param engines
+ * @param with_coefficients Whether to compare the coefficients, which takes
+ *     much longer than comparing the values at the queries.
+ * @param summaries Updated with the results of each engine.
+ *
+ * @return `true` if no engine exceeded its tolerance, else `false`.
+ *****************************************************************************/
+static bool compare(Workload const& workload, std::vector<Engine> const& engines, bool with_coefficients,
+                    std::vector<Summary>& summaries)
+{
+    std::vector<Rational> exact_coefficients;
+    if(with_coefficients)
+    {
+        exact_coefficients = interpolate_exactly(workload.xcoords, workload.ycoords);
+    }
+    std::vector<Rational> exact_predictions;
+    for(double query: workload.queries)
+    {
+        exact_predictions.push_back(evaluate_exactly(workload.xcoords, workload.ycoords, query));
+    }
+    double largest_coefficient = 0;
+    for(auto const& coefficient: exact_coefficients)
+    {
+        largest_coefficient = std::max(largest_coefficient, std::abs(coefficient.to_double()));
+    }
+    Bounds bounds = bound(workload);
+
+    // An error of 0 never exceeds its bound, even if that is 0.
+    auto excess = [](double error, double bound)
+    {
+        return error == 0 ? 0 : error / bound;
+    };
+    bool within_tolerance = true;
+    std::vector<double> coefficients, predictions;
+    for(std::size_t i = 0; i < engines.size(); ++i)
+    {
+        if(!engines[i].applies(workload))
+        {
+            continue;
+        }
+        double time = measure([&]{ engines[i].run(workload, coefficients, predictions); });
+        Summary& summary = summaries[i];
+        double coefficient_ulps = 0, coefficient_error = 0, worst_excess = 0;
+        for(std::size_t k = 0; with_coefficients && (k < coefficients.size() || k < exact_coefficients.size()); ++k)
+        {
+            double computed = k < coefficients.size() ? coefficients[k] : 0;
+            Rational const& exact = k < exact_coefficients.size() ? exact_coefficients[k] : Rational();
+            double error = std::abs((Rational(computed) - exact).to_double());
+            coefficient_ulps = std::max(coefficient_ulps, ulps(computed, exact));
+            coefficient_error = std::max(coefficient_error, error);
+            if(!coefficients.empty())
+            {
+                double bound = k < bounds.coefficients.size() ? bounds.coefficients[k] : 0;
+                worst_excess = std::max(worst_excess, excess(error, bound));
+            }
+        }
+        coefficient_error /= largest_coefficient > 0 ? largest_coefficient : 1;
+        double prediction_ulps = 0, prediction_error = 0;
+        for(std::size_t q = 0; q < predictions.size(); ++q)
+        {
+            Rational const& exact = exact_predictions[q];
+            double error = std::abs((Rational(predictions[q]) - exact).to_double());
+            double bound = coefficients.empty() ? bounds.lagrange[q] : bounds.monomial[q];
+            prediction_ulps = std::max(prediction_ulps, ulps(predictions[q], exact));
+            prediction_error = std::max(prediction_error,
+                                        error / (exact.sign() != 0 ? std::abs(exact.to_double()) : 1));
+            worst_excess = std::max(worst_excess, excess(error, bound));
+        }
+
+        std::cout << workload.name << ", " << workload.set << ", " << workload.xcoords.size() << ", "
+                  << engines[i].name << ", " << time * 1e6 << ", ";
+        if(coefficients.empty() || !with_coefficients)
+        {
+            std::cout << "-, -, ";
+        }
+        else
+        {
+            std::cout << coefficient_ulps << ", " << coefficient_error << ", ";
+            summary.has_coefficients = true;
+            summary.coefficient_ulps = std::max(summary.coefficient_ulps, coefficient_ulps);
+            summary.coefficient_error = std::max(summary.coefficient_error, coefficient_error);
+        }
+        if(predictions.empty())
+        {
+            std::cout << "-, -, ";
+        }
+        else
+        {
+            std::cout << prediction_ulps << ", " << prediction_error << ", ";
+            summary.has_predictions = true;
+            summary.prediction_ulps = std::max(summary.prediction_ulps, prediction_ulps);
+            summary.prediction_error = std::max(summary.prediction_error, prediction_error);
+        }
+        std::cout << worst_excess << "\n";
+        ++summary.num_of_sets;
+        summary.time += time;
+        summary.excess = std::max(summary.excess, worst_excess);
+
+        double tolerance = engines[i].tolerance + engines[i].tolerance_per_point * workload.xcoords.size();
+        if(!(worst_excess <= tolerance))
+        {
+            std::cerr << "Engine " << engines[i].name << " exceeded its tolerance on file " << workload.name
+                      << ", set " << workload.set << ": its errors were up to " << worst_excess
+                      << " times their bounds, more than " << tolerance << ".\n";
+            within_tolerance = false;
+        }
+    }
+    return within_tolerance;
+}
+
+/******************************************************************************
+ * Main function. Compare every engine which interpolates sets of points with
+ * the exact rational reference, on each set in the given input files, and
+ * display the time taken by each and the errors in units in the last place,
+ * relative to the exact result and relative to the bound on the error caused
+ * by rounding the data; then the total time and worst errors of each engine.
+ * The coefficients of sets with more points than `--max-points` are not
+ * compared (only the values at the queries are), because finding the exact
+ * ones takes time which grows very quickly with the number of points.
+ *
+ * @return `EXIT_SUCCESS` if every set could be read and no engine exceeded its
+ *     tolerance, else `EXIT_FAILURE`.
+ *****************************************************************************/
+int main(int const argc, char const* argv[])
+{
+    std::size_t max_points = 64;
+    std::vector<char const*> paths;
+    for(int i = 1; i < argc; ++i)
+    {
+        if(std::string(argv[i]) == "--max-points" && i + 1 < argc)
+        {
+            max_points = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else
+        {
+            paths.push_back(argv[i]);
+        }
+    }
+    if(paths.empty())
+    {
+        std::cerr << "Usage:\n";
+        std::cerr << "  " << argv[0] << " [--max-points <count>] <input file> [<input file> ...]\n";
+        return EXIT_FAILURE;
+    }
+
+    std::vector<Engine> all_engines = engines();
+    std::vector<Summary> summaries(all_engines.size());
+    int status = EXIT_SUCCESS;
+    std::cout << std::setprecision(3);
+    std::cout << "file, set, points, engine, time (µs), coefficient error (ULP), coefficient error (relative), "
+              << "prediction error (ULP), prediction error (relative), error (multiple of bound)\n";
+    for(auto const& path: paths)
+    {
+        std::string contents;
+        if(!read_file(path, contents))
+        {
+            std::cerr << "File " << path << " could not be read.\n";
+            status = EXIT_FAILURE;
+            continue;
+        }
+        Stream stream(std::move(contents));
+        char const* begin;
+        char const* end;
+        for(std::size_t set = 1; stream.next(begin, end); ++set)
+        {
+            Workload workload;
+            workload.name = path;
+            workload.set = set;
+            try
+            {
+                Points points;
+                parse_points(begin, end, points);
+                workload.xcoords = std::move(points.xcoords);
+                workload.ycoords = std::move(points.ycoords);
+                workload.queries = std::move(points.queries);
+                bool with_coefficients = workload.xcoords.size() <= max_points;
+                if(!with_coefficients)
+                {
+                    std::cerr << "File " << path << ", set " << set << " has more than " << max_points
+                              << " points; only the values at the queries are compared.\n";
+                }
+                if(!compare(workload, all_engines, with_coefficients, summaries))
+                {
+                    status = EXIT_FAILURE;
+                }
+            }
+            catch(std::invalid_argument const& e)
+            {
+                std::cerr << "File " << path << ", set " << set << ": " << e.what() << "\n";
+                status = EXIT_FAILURE;
+            }
+        }
+    }
+
+    std::cout << "\nengine, sets, total time (µs), worst coefficient error (ULP), worst coefficient error (relative), "
+              << "worst prediction error (ULP), worst prediction error (relative), worst error (multiple of bound), "
+              << "tolerance (multiple of bound, for n points)\n";
+    for(std::size_t i = 0; i < all_engines.size(); ++i)
+    {
+        Summary const& summary = summaries[i];
+        std::cout << all_engines[i].name << ", " << summary.num_of_sets << ", " << summary.time * 1e6 << ", ";
+        if(summary.has_coefficients)
+        {
+            std::cout << summary.coefficient_ulps << ", " << summary.coefficient_error << ", ";
+        }
+        else
+        {
+            std::cout << "-, -, ";
+        }
+        if(summary.has_predictions)
+        {
+            std::cout << summary.prediction_ulps << ", " << summary.prediction_error << ", ";
+        }
+        else
+        {
+            std::cout << "-, -, ";
+        }
+        std::cout << summary.excess << ", " << describe_tolerance(all_engines[i]) << "\n";
+    }
+    return status;
+}
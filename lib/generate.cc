@@ -0,0 +1,519 @@
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Trace.hh"
+
+// The elementary functions of the C library are not correctly rounded, and
+// differ in the last place from one implementation to another. These use only
+// the basic arithmetic operations and the square root, which IEEE 754 requires
+// to be correctly rounded, so that they give the same results on any machine.
+// They are accurate to a few units in the last place in the ranges used here.
+#define LN2_HIGH 6.93147180369123816490e-01
+#define LN2_LOW 1.90821492927058770002e-10
+#define PI_BY_2_HIGH 1.57079632673412561417e+00
+#define PI_BY_2_LOW 6.07710050650619224932e-11
+
+/******************************************************************************
+ * Sum a Taylor series whose successive terms are in the ratio `-t * t / ((k +
+ * 1) * (k + 2))`, such as that of the cosine (starting from 0) or the sine
+ * (starting from 1), divided by its first term.
+ *
+ * @param t Number of magnitude at most about pi/4.
+ * @param first Index of the first term.
+ *
+ * @return Sum.
+ *****************************************************************************/
+static double alternating_series(double t, int first)
+{
+    double sum = 1;
+    for(int k = first + 20; k > first; k -= 2)
+    {
+        sum = 1 - t * t / ((k - 1) * k) * sum;
+    }
+    return sum;
+}
+
+/******************************************************************************
+ * @param x Number of magnitude less than about a million.
+ *
+ * @return Cosine of `x`.
+ *****************************************************************************/
+static double cosine(double x)
+{
+    // Subtract the nearest multiple of pi/2 (in two parts, so that little
+    // accuracy is lost), and find the quadrant from its coefficient.
+    double k = std::floor(x / PI_BY_2_HIGH + 0.5);
+    double r = (x - k * PI_BY_2_HIGH) - k * PI_BY_2_LOW;
+    switch(static_cast<long long>(k) & 3)
+    {
+        case 0:
+            return alternating_series(r, 0);
+        case 1:
+            return -r * alternating_series(r, 1);
+        case 2:
+            return -alternating_series(r, 0);
+        default:
+            return r * alternating_series(r, 1);
+    }
+}
+
+/******************************************************************************
+ * @param x Positive finite number.
+ *
+ * @return Natural logarithm of `x`.
+ *****************************************************************************/
+static double logarithm(double x)
+{
+    // With `x` the product of `m` (between 1/sqrt(2) and sqrt(2)) and a power
+    // of 2, the logarithm of `m` is twice the inverse hyperbolic tangent of
+    // `s`, which is at most 0.172.
+    int exponent;
+    double m = std::frexp(x, &exponent);
+    if(m < 0.70710678118654752440)
+    {
+        m *= 2;
+        --exponent;
+    }
+    double s = (m - 1) / (m + 1);
+    double sum = 0;
+    for(int k = 25; k >= 1; k -= 2)
+    {
+        sum = 1.0 / k + s * s * sum;
+    }
+    return exponent * LN2_HIGH + (exponent * LN2_LOW + 2 * s * sum);
+}
+
+/******************************************************************************
+ * @param x Number between about -700 and 700.
+ *
+ * @return Exponential of `x`.
+ *****************************************************************************/
+static double exponential(double x)
+{
+    // Subtract the nearest multiple of log(2), whose coefficient is then the
+    // exponent of the power of 2 to multiply by.
+    double k = std::floor(x / LN2_HIGH + 0.5);
+    double r = (x - k * LN2_HIGH) - k * LN2_LOW;
+    double sum = 1;
+    for(int i = 20; i >= 1; --i)
+    {
+        sum = 1 + r / i * sum;
+    }
+    return std::ldexp(sum, static_cast<int>(k));
+}
+
+// Source of random numbers which gives the same numbers for the same seed on
+// any machine and with any standard library (unlike the distributions in
+// `<random>`). The generator is SplitMix64.
+class Random
+{
+    private:
+    std::uint64_t state;
+
+    public:
+    Random(std::uint64_t seed)
+    : state(seed)
+    {
+    }
+    std::uint64_t next(void)
+    {
+        std::uint64_t z = (this->state += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+    double uniform(void)
+    {
+        return (this->next() >> 11) * 0x1p-53;
+    }
+    double normal(void)
+    {
+        // Marsaglia's polar method.
+        double u, v, s;
+        do
+        {
+            u = 2 * this->uniform() - 1;
+            v = 2 * this->uniform() - 1;
+            s = u * u + v * v;
+        }
+        while(s >= 1 || s == 0);
+        return u * std::sqrt(-2 * logarithm(s) / s);
+    }
+};
+
+// What to generate.
+struct Settings
+{
+    std::uint64_t seed = 1;
+    std::size_t num_of_sets = 1;
+    std::size_t min_points = 6, max_points = 6;
+    std::string nodes = "equispaced";
+    std::string values = "integer";
+    std::size_t degree = 3;
+    double noise = 0;
+    std::size_t num_of_queries = 1;
+    std::string format = "text";
+    double rate = 1000;
+    char const* output = nullptr;
+};
+
+/******************************************************************************
+ * Generate x-coordinates, in ascending order.
+ *
+ * @param family `equispaced` (1, 2, 3 and so on), `chebyshev` (Chebyshev
+ *     nodes of the first kind in [-1, 1]), `random` (uniformly distributed in
+ *     [0, n)), `clustered` (normally distributed around a few centres) or
+ *     `near-duplicate` (equispaced, but with every other node moved to within
+ *     a millionth of the previous one).
+ * @param num_of_points
+ * @param random
+ * @param xcoords Array to store the x-coordinates in.
+ *****************************************************************************/
+static void make_nodes(std::string const& family, std::size_t num_of_points, Random& random,
+                       std::vector<double>& xcoords)
+{
+    xcoords.resize(num_of_points);
+    if(family == "equispaced")
+    {
+        for(std::size_t i = 0; i < num_of_points; ++i)
+        {
+            xcoords[i] = i + 1.0;
+        }
+    }
+    else if(family == "chebyshev")
+    {
+        for(std::size_t i = 0; i < num_of_points; ++i)
+        {
+            xcoords[i] = -cosine((2 * i + 1) * M_PI / (2 * num_of_points));
+        }
+    }
+    else if(family == "random")
+    {
+        for(auto& xcoord: xcoords)
+        {
+            xcoord = random.uniform() * num_of_points;
+        }
+        std::sort(xcoords.begin(), xcoords.end());
+    }
+    else if(family == "clustered")
+    {
+        std::size_t num_of_clusters = std::max<std::size_t>(num_of_points / 16, 1);
+        std::vector<double> centres(num_of_clusters);
+        for(auto& centre: centres)
+        {
+            centre = random.uniform() * num_of_points;
+        }
+        for(auto& xcoord: xcoords)
+        {
+            xcoord = centres[random.next() % num_of_clusters] + 0.05 * random.normal();
+        }
+        std::sort(xcoords.begin(), xcoords.end());
+    }
+    else if(family == "near-duplicate")
+    {
+        for(std::size_t i = 0; i < num_of_points; ++i)
+        {
+            xcoords[i] = i % 2 == 0 ? i + 1.0 : i + 1e-6 * (1 + random.uniform());
+        }
+    }
+    else
+    {
+        throw std::invalid_argument("Unknown family of nodes: " + family + ".");
+    }
+}
+
+/******************************************************************************
+ * Generate y-coordinates.
+ *
+ * @param settings Family (`integer`: an increasing sequence of integers with
+ *     small random steps; `smooth`: a smooth function with normally
+ *     distributed noise of standard deviation `noise`; `polynomial`: a
+ *     polynomial of degree `degree` with random coefficients in [-1, 1]).
+ * @param xcoords
+ * @param random
+ * @param ycoords Array to store the y-coordinates in.
+ *****************************************************************************/
+static void make_values(Settings const& settings, std::vector<double> const& xcoords, Random& random,
+                        std::vector<double>& ycoords)
+{
+    std::size_t num_of_points = xcoords.size();
+    ycoords.resize(num_of_points);
+    if(settings.values == "integer")
+    {
+        double ycoord = random.next() % 10;
+        for(auto& y: ycoords)
+        {
+            y = ycoord;
+            ycoord += random.next() % 10;
+        }
+    }
+    else if(settings.values == "smooth")
+    {
+        double first = xcoords.front(), width = std::max(xcoords.back() - first, 1e-300);
+        for(std::size_t i = 0; i < num_of_points; ++i)
+        {
+            double t = (xcoords[i] - first) / width;
+            ycoords[i] = exponential(t) * cosine(3 * t) + settings.noise * random.normal();
+        }
+    }
+    else if(settings.values == "polynomial")
+    {
+        std::vector<double> coefficients(settings.degree + 1);
+        for(auto& coefficient: coefficients)
+        {
+            coefficient = 2 * random.uniform() - 1;
+        }
+        for(std::size_t i = 0; i < num_of_points; ++i)
+        {
+            double ycoord = 0;
+            for(auto it = coefficients.rbegin(); it != coefficients.rend(); ++it)
+            {
+                ycoord = ycoord * xcoords[i] + *it;
+            }
+            ycoords[i] = ycoord;
+        }
+    }
+    else
+    {
+        throw std::invalid_argument("Unknown family of values: " + settings.values + ".");
+    }
+}
+
+/******************************************************************************
+ * Generate x-coordinates to evaluate the interpolating polynomial at: the one
+ * which would follow the last node if the last two were repeated, then random
+ * ones between the first and the last node.
+ *
+ * @param num_of_queries
+ * @param xcoords
+ * @param random
+ * @param queries Array to store the x-coordinates in.
+ *****************************************************************************/
+static void make_queries(std::size_t num_of_queries, std::vector<double> const& xcoords, Random& random,
+                         std::vector<double>& queries)
+{
+    queries.resize(num_of_queries);
+    std::size_t n = xcoords.size();
+    for(std::size_t i = 0; i < num_of_queries; ++i)
+    {
+        if(i == 0)
+        {
+            queries[i] = n >= 2 ? 2 * xcoords[n - 1] - xcoords[n - 2] : xcoords[0] + 1;
+        }
+        else
+        {
+            queries[i] = xcoords[0] + random.uniform() * (xcoords[n - 1] - xcoords[0]);
+        }
+    }
+}
+
+/******************************************************************************
+ * Parse a number of points. Only digits are accepted: `strtoull` would also
+ * skip leading white space and negate a leading minus sign.
+ *
+ * @param begin Start of the number. Updated to the first character after it.
+ * @param count Variable to store the number in.
+ *
+ * @return Whether a number which fits in a trace was read.
+ *****************************************************************************/
+static bool parse_count(char const*& begin, std::size_t& count)
+{
+    if(*begin < '0' || *begin > '9')
+    {
+        return false;
+    }
+    char* end;
+    errno = 0;
+    unsigned long long value = std::strtoull(begin, &end, 10);
+    begin = end;
+    count = value;
+    return errno == 0 && value <= std::numeric_limits<std::uint32_t>::max();
+}
+
+/******************************************************************************
+ * Parse a number of points, or a range of numbers of points.
+ *
+ * @param str `n` or `min-max`.
+ * @param settings Object to store the range in.
+ *
+ * @return Whether `str` was valid. The range itself is checked by the caller.
+ *****************************************************************************/
+static bool parse_points(char const* str, Settings& settings)
+{
+    if(!parse_count(str, settings.min_points))
+    {
+        return false;
+    }
+    settings.max_points = settings.min_points;
+    if(*str == '-' && !parse_count(++str, settings.max_points))
+    {
+        return false;
+    }
+    return *str == '\0';
+}
+
+/******************************************************************************
+ * Main function. Write sets of points in the input format of the main
+ * program (`text` or `y-only`) or as a trace (`binary`, see `TraceWriter`),
+ * in which the sets arrive at random at the given rate. The same settings
+ * always give the same output.
+ *****************************************************************************/
+int main(int const argc, char const* argv[])
+{
+    Settings settings;
+    bool valid = true;
+    for(int i = 1; i < argc; ++i)
+    {
+        std::string argument = argv[i];
+        if(i + 1 >= argc)
+        {
+            valid = false;
+        }
+        else if(argument == "--seed")
+        {
+            settings.seed = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if(argument == "--sets")
+        {
+            settings.num_of_sets = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if(argument == "--points")
+        {
+            valid = parse_points(argv[++i], settings) && valid;
+        }
+        else if(argument == "--nodes")
+        {
+            settings.nodes = argv[++i];
+        }
+        else if(argument == "--values")
+        {
+            settings.values = argv[++i];
+        }
+        else if(argument == "--degree")
+        {
+            settings.degree = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if(argument == "--noise")
+        {
+            settings.noise = std::strtod(argv[++i], nullptr);
+        }
+        else if(argument == "--queries")
+        {
+            settings.num_of_queries = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if(argument == "--format")
+        {
+            settings.format = argv[++i];
+        }
+        else if(argument == "--rate")
+        {
+            settings.rate = std::strtod(argv[++i], nullptr);
+        }
+        else if(argument == "--output")
+        {
+            settings.output = argv[++i];
+        }
+        else
+        {
+            valid = false;
+        }
+    }
+    bool binary = settings.format == "binary";
+    valid = valid && settings.min_points >= 2 && settings.max_points >= settings.min_points
+            && (settings.format == "text" || settings.format == "y-only" || binary) && settings.rate > 0
+            && (settings.output != nullptr || !binary);
+    if(!valid)
+    {
+        std::cerr << "Usage:\n";
+        std::cerr << "  " << argv[0] << " [--seed <seed>] [--sets <count>] [--points <count>[-<count>]]"
+                  << " [--nodes equispaced|chebyshev|random|clustered|near-duplicate]"
+                  << " [--values integer|smooth|polynomial] [--degree <degree>] [--noise <deviation>]"
+                  << " [--queries <count>] [--format text|y-only|binary] [--rate <sets per second>]"
+                  << " [--output <file>]\n";
+        std::cerr << "The output file is required in the binary format.\n";
+        return EXIT_FAILURE;
+    }
+
+    std::unique_ptr<TraceWriter> trace;
+    std::FILE* file = stdout;
+    try
+    {
+        if(binary)
+        {
+            trace = std::make_unique<TraceWriter>(settings.output);
+        }
+        else if(settings.output != nullptr && (file = std::fopen(settings.output, "w")) == nullptr)
+        {
+            std::cerr << "File " << settings.output << " could not be written.\n";
+            return EXIT_FAILURE;
+        }
+
+        // Sizes are distributed log-uniformly, so that small sets are as
+        // common as large ones on a logarithmic scale.
+        Random random(settings.seed);
+        Request request;
+        double time = 0;
+        for(std::size_t set = 0; set < settings.num_of_sets; ++set)
+        {
+            double ratio = static_cast<double>(settings.max_points) / settings.min_points;
+            double scale = exponential(logarithm(ratio) * random.uniform());
+            std::size_t num_of_points = std::min<std::size_t>(std::llround(settings.min_points * scale),
+                                                              settings.max_points);
+            make_nodes(settings.nodes, num_of_points, random, request.xcoords);
+            make_values(settings, request.xcoords, random, request.ycoords);
+            make_queries(settings.num_of_queries, request.xcoords, random, request.queries);
+            if(binary)
+            {
+                // Arrivals are a Poisson process.
+                time += -logarithm(1 - random.uniform()) / settings.rate;
+                trace->record(request, static_cast<std::uint64_t>(time * 1e9));
+                continue;
+            }
+            if(set > 0)
+            {
+                std::fputc('\n', file);
+            }
+            for(std::size_t i = 0; i < num_of_points; ++i)
+            {
+                if(settings.format == "y-only")
+                {
+                    std::fprintf(file, "%.17g\n", request.ycoords[i]);
+                }
+                else
+                {
+                    std::fprintf(file, "%.17g %.17g\n", request.xcoords[i], request.ycoords[i]);
+                }
+            }
+            for(std::size_t i = 0; i < request.queries.size() && settings.format == "text"; ++i)
+            {
+                std::fprintf(file, "%.17g\n", request.queries[i]);
+            }
+        }
+        if(binary)
+        {
+            trace->close();
+        }
+    }
+    catch(std::exception const& e)
+    {
+        std::cerr << e.what() << "\n";
+        return EXIT_FAILURE;
+    }
+    if(file != stdout && std::fclose(file) != 0)
+    {
+        std::cerr << "File " << settings.output << " could not be written.\n";
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
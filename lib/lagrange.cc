@@ -0,0 +1,268 @@
+#include <cmath>
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <vector>
+
+#include "Cancellation.hh"
+#include "Polynomial.hh"
+#include "lagrange.h"
+
+// The opaque type handed out to C programs.
+struct lip_polynomial
+{
+    Polynomial polynomial;
+};
+
+/******************************************************************************
+ * Translate the exception being handled into a status code. Must only be
+ * called from within a `catch` block.
+ *
+ * @return Status code.
+ *****************************************************************************/
+static int status(void)
+{
+    try
+    {
+        throw;
+    }
+    catch(std::invalid_argument const&)
+    {
+        return LIP_EINVAL;
+    }
+    catch(Expired const&)
+    {
+        return LIP_ETIMEDOUT;
+    }
+    catch(std::bad_alloc const&)
+    {
+        return LIP_ENOMEM;
+    }
+    catch(...)
+    {
+        return LIP_EFAIL;
+    }
+}
+
+/******************************************************************************
+ * Obtain the version of the C interface the library was built with.
+ *
+ * @return `LIP_ABI_VERSION`.
+ *****************************************************************************/
+int lip_abi_version(void)
+{
+    return LIP_ABI_VERSION;
+}
+
+/******************************************************************************
+ * Create a token which expires after the given number of seconds.
+ *
+ * @param timeout Number of seconds. If it is not positive, or too large to be
+ *     represented (e.g. infinite), the token never expires, as with the
+ *     `--timeout` option of the main program. Must not be NaN.
+ *
+ * @return Token.
+ *****************************************************************************/
+static Cancellation deadline(double timeout)
+{
+    if(timeout <= 0)
+    {
+        return Cancellation();
+    }
+    return Cancellation(to_duration(timeout));
+}
+
+/******************************************************************************
+ * Find the interpolating polynomial passing through the given points.
+ *
+ * @param xcoords Array of x-coordinates.
+ * @param ycoords Array of y-coordinates.
+ * @param num_of_points Length of each array.
+ * @param cancellation Token polled periodically, or `nullptr`.
+ * @param polynomial Where to store the polynomial.
+ *
+ * @return Status code.
+ *****************************************************************************/
+static int interpolate(double const* xcoords, double const* ycoords, std::size_t num_of_points,
+                       Cancellation const* cancellation, lip_polynomial** polynomial)
+{
+    if(xcoords == nullptr || ycoords == nullptr || polynomial == nullptr)
+    {
+        return LIP_EINVAL;
+    }
+    try
+    {
+        std::vector<double> xcoords_(xcoords, xcoords + num_of_points);
+        std::vector<double> ycoords_(ycoords, ycoords + num_of_points);
+        *polynomial = new lip_polynomial{Polynomial(xcoords_, ycoords_, Precision::standard, cancellation)};
+    }
+    catch(...)
+    {
+        return status();
+    }
+    return LIP_OK;
+}
+
+/******************************************************************************
+ * Find the interpolating polynomial passing through the given points.
+ *
+ * @param xcoords Array of x-coordinates.
+ * @param ycoords Array of y-coordinates.
+ * @param num_of_points Length of each array.
+ * @param polynomial Where to store the polynomial. It must be released using
+ *     `lip_free`. Nothing is stored if an error occurs.
+ *
+ * @return `LIP_OK` on success, `LIP_EINVAL` if there are fewer than two points
+ *     or the x-coordinates are not distinct, `LIP_ENOMEM` if memory could not
+ *     be allocated and `LIP_EFAIL` for any other error.
+ *****************************************************************************/
+int lip_interpolate(double const* xcoords, double const* ycoords, std::size_t num_of_points,
+                    lip_polynomial** polynomial)
+{
+    return interpolate(xcoords, ycoords, num_of_points, nullptr, polynomial);
+}
+
+/******************************************************************************
+ * Find the interpolating polynomial passing through the given points, giving
+ * up if that takes too long.
+ *
+ * @param xcoords Array of x-coordinates.
+ * @param ycoords Array of y-coordinates.
+ * @param num_of_points Length of each array.
+ * @param timeout Number of seconds after which to give up. If it is not
+ *     positive, there is no timeout.
+ * @param polynomial Where to store the polynomial. It must be released using
+ *     `lip_free`. Nothing is stored if an error occurs.
+ *
+ * @return As `lip_interpolate`, `LIP_EINVAL` also if `timeout` is NaN, or
+ *     `LIP_ETIMEDOUT` if the timeout expired.
+ *****************************************************************************/
+int lip_interpolate_timeout(double const* xcoords, double const* ycoords, std::size_t num_of_points,
+                            double timeout, lip_polynomial** polynomial)
+{
+    if(std::isnan(timeout))
+    {
+        return LIP_EINVAL;
+    }
+    Cancellation cancellation = deadline(timeout);
+    return interpolate(xcoords, ycoords, num_of_points, &cancellation, polynomial);
+}
+
+/******************************************************************************
+ * Copy the coefficients of a polynomial into a buffer, in increasing order of
+ * the exponent of the variable. The zero polynomial has no coefficients.
+ *
+ * @param polynomial
+ * @param coefficients Buffer to copy the coefficients into.
+ * @param capacity Length of the buffer.
+ * @param num_of_coefficients Where to store the number of coefficients. May be
+ *     `NULL`.
+ *
+ * @return `LIP_OK` on success, `LIP_ERANGE` if the buffer is too small (in
+ *     which case the number of coefficients is still stored) and `LIP_EINVAL`
+ *     if a required argument is `NULL`.
+ *****************************************************************************/
+int lip_coefficients(lip_polynomial const* polynomial, double* coefficients, std::size_t capacity,
+                     std::size_t* num_of_coefficients)
+{
+    if(polynomial == nullptr || (coefficients == nullptr && capacity > 0))
+    {
+        return LIP_EINVAL;
+    }
+    std::size_t size = polynomial->polynomial.size();
+    if(num_of_coefficients != nullptr)
+    {
+        *num_of_coefficients = size;
+    }
+    if(size > capacity)
+    {
+        return LIP_ERANGE;
+    }
+    for(std::size_t i = 0; i < size; ++i)
+    {
+        coefficients[i] = polynomial->polynomial[i];
+    }
+    return LIP_OK;
+}
+
+/******************************************************************************
+ * Evaluate a polynomial at several points.
+ *
+ * @param polynomial
+ * @param xcoords Array of x-coordinates to evaluate the polynomial at.
+ * @param ycoords Array to write the y-coordinates to.
+ * @param count Length of each array.
+ * @param cancellation Token polled periodically, or `nullptr`.
+ *
+ * @return Status code.
+ *****************************************************************************/
+static int evaluate(lip_polynomial const* polynomial, double const* xcoords, double* ycoords, std::size_t count,
+                    Cancellation const* cancellation)
+{
+    if(polynomial == nullptr || ((xcoords == nullptr || ycoords == nullptr) && count > 0))
+    {
+        return LIP_EINVAL;
+    }
+    try
+    {
+        polynomial->polynomial.evaluate(xcoords, ycoords, count, cancellation);
+    }
+    catch(...)
+    {
+        return status();
+    }
+    return LIP_OK;
+}
+
+/******************************************************************************
+ * Evaluate a polynomial at several points.
+ *
+ * @param polynomial
+ * @param xcoords Array of x-coordinates to evaluate the polynomial at.
+ * @param ycoords Array to write the y-coordinates to. It may be the same as
+ *     `xcoords`.
+ * @param count Length of each array.
+ *
+ * @return `LIP_OK` on success and `LIP_EINVAL` if a required argument is
+ *     `NULL`.
+ *****************************************************************************/
+int lip_eval_batch(lip_polynomial const* polynomial, double const* xcoords, double* ycoords, std::size_t count)
+{
+    return evaluate(polynomial, xcoords, ycoords, count, nullptr);
+}
+
+/******************************************************************************
+ * Evaluate a polynomial at several points, giving up if that takes too long.
+ *
+ * @param polynomial
+ * @param xcoords Array of x-coordinates to evaluate the polynomial at.
+ * @param ycoords Array to write the y-coordinates to. It may be the same as
+ *     `xcoords`.
+ * @param count Length of each array.
+ * @param timeout Number of seconds after which to give up. If it is not
+ *     positive, there is no timeout.
+ *
+ * @return As `lip_eval_batch`, `LIP_EINVAL` also if `timeout` is NaN, or
+ *     `LIP_ETIMEDOUT` if the timeout expired (in which case only some
+ *     y-coordinates will have been written).
+ *****************************************************************************/
+int lip_eval_batch_timeout(lip_polynomial const* polynomial, double const* xcoords, double* ycoords,
+                           std::size_t count, double timeout)
+{
+    if(std::isnan(timeout))
+    {
+        return LIP_EINVAL;
+    }
+    Cancellation cancellation = deadline(timeout);
+    return evaluate(polynomial, xcoords, ycoords, count, &cancellation);
+}
+
+/******************************************************************************
+ * Release a polynomial.
+ *
+ * @param polynomial Polynomial obtained from `lip_interpolate`, or `NULL`.
+ *****************************************************************************/
+void lip_free(lip_polynomial* polynomial)
+{
+    delete polynomial;
+}
@@ -0,0 +1,228 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Channel.hh"
+#include "Metrics.hh"
+#include "Polynomial.hh"
+#include "Trace.hh"
+
+// How to replay a trace.
+struct Settings
+{
+    bool fast = false;
+    double speed = 1;
+    std::size_t num_of_threads = 1;
+    char const* channel_name = nullptr;
+};
+
+/******************************************************************************
+ * Carry out a request using the library.
+ *
+ * @param request
+ * @param values Array to store the values at the queries in.
+ *
+ * @return `true` if it succeeded, else `false`.
+ *****************************************************************************/
+static bool carry_out(Request const& request, double* values)
+{
+    try
+    {
+        Polynomial p = request.y_only ? Polynomial(request.start, request.step, request.ycoords)
+                                      : Polynomial(request.xcoords, request.ycoords);
+        p.evaluate(request.queries.data(), values, request.queries.size());
+    }
+    catch(std::invalid_argument const&)
+    {
+        return false;
+    }
+    return true;
+}
+
+/******************************************************************************
+ * Carry out a request using a server (see `Channel`).
+ *
+ * @param request
+ * @param channel
+ *
+ * @return `true` if it succeeded, else `false`.
+ *****************************************************************************/
+static bool carry_out(Request const& request, Channel& channel)
+{
+    std::size_t num_of_points = request.ycoords.size();
+    Slot slot;
+    try
+    {
+        slot = channel.acquire(num_of_points, request.queries.size());
+    }
+    catch(std::length_error const&)
+    {
+        return false;
+    }
+    for(std::size_t i = 0; i < num_of_points; ++i)
+    {
+        slot.xcoords[i] = request.y_only ? request.start + i * request.step : request.xcoords[i];
+        slot.ycoords[i] = request.ycoords[i];
+    }
+    std::copy(request.queries.begin(), request.queries.end(), slot.queries);
+    channel.submit(slot);
+    bool succeeded = channel.wait(slot) && slot.descriptor->status == EXIT_SUCCESS;
+    channel.release(slot);
+    return succeeded;
+}
+
+/******************************************************************************
+ * Replay the requests in a trace. Each thread takes the next request, waits
+ * until the time it is due (unless replaying as fast as possible), and carries
+ * it out. Its latency is measured from when it was due, rather than from when
+ * it was started, so that requests held up behind slow ones are not left out
+ * of the account.
+ *
+ * @param requests
+ * @param settings
+ *
+ * @return Exit status.
+ *****************************************************************************/
+static int replay(std::vector<Request> const& requests, Settings const& settings)
+{
+    std::unique_ptr<Channel> channel;
+    if(settings.channel_name != nullptr)
+    {
+        channel = std::make_unique<Channel>(settings.channel_name);
+    }
+    std::vector<std::unique_ptr<Histogram>> histograms;
+    for(std::size_t i = 0; i < settings.num_of_threads; ++i)
+    {
+        histograms.push_back(std::make_unique<Histogram>());
+    }
+    std::atomic<std::size_t> next(0), num_of_failures(0);
+    auto begin = std::chrono::steady_clock::now();
+    auto work = [&](Histogram& histogram)
+    {
+        std::vector<double> values;
+        for(std::size_t i = next++; i < requests.size(); i = next++)
+        {
+            Request const& request = requests[i];
+            auto due = std::chrono::steady_clock::now();
+            if(!settings.fast)
+            {
+                auto offset = std::chrono::duration<double, std::nano>((request.time - requests[0].time)
+                                                                       / settings.speed);
+                due = begin + std::chrono::duration_cast<std::chrono::steady_clock::duration>(offset);
+                std::this_thread::sleep_until(due);
+            }
+            values.resize(request.queries.size());
+            bool succeeded = channel != nullptr ? carry_out(request, *channel) : carry_out(request, values.data());
+            if(!succeeded)
+            {
+                ++num_of_failures;
+            }
+            histogram.record(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                 std::chrono::steady_clock::now() - due).count());
+        }
+    };
+    std::vector<std::thread> threads;
+    for(std::size_t i = 0; i < settings.num_of_threads; ++i)
+    {
+        threads.emplace_back(work, std::ref(*histograms[i]));
+    }
+    for(auto& thread: threads)
+    {
+        thread.join();
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    Histogram latencies;
+    for(auto const& histogram: histograms)
+    {
+        latencies.merge(*histogram);
+    }
+    std::cout << "Requests: " << requests.size() << " (" << num_of_failures << " failed)\n";
+    std::cout << std::fixed << std::setprecision(3) << "Elapsed: " << elapsed << " s\n";
+    std::cout << std::setprecision(1) << "Throughput: " << requests.size() / elapsed << " requests/s\n";
+    struct
+    {
+        char const* name;
+        double fraction;
+    } quantiles[] = {{"p50", 0.5}, {"p90", 0.9}, {"p99", 0.99}, {"p99.9", 0.999}, {"max", 1}};
+    std::cout << "Latency:";
+    for(auto const& quantile: quantiles)
+    {
+        std::cout << (quantile.fraction == 0.5 ? " " : ", ") << quantile.name << " "
+                  << latencies.quantile(quantile.fraction) / 1000.0 << " µs";
+    }
+    std::cout << "\n";
+    return num_of_failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/******************************************************************************
+ * Main function. Replay a trace recorded by the main program, against the
+ * library or a server, and report the throughput and the latency.
+ *****************************************************************************/
+int main(int const argc, char const* argv[])
+{
+    Settings settings;
+    char const* path = nullptr;
+    for(int i = 1; i < argc; ++i)
+    {
+        std::string argument = argv[i];
+        if(argument == "--fast")
+        {
+            settings.fast = true;
+        }
+        else if(argument == "--speed" && i + 1 < argc)
+        {
+            settings.speed = std::strtod(argv[++i], nullptr);
+        }
+        else if(argument == "--threads" && i + 1 < argc)
+        {
+            settings.num_of_threads = std::max(std::strtoull(argv[++i], nullptr, 10), 1ULL);
+        }
+        else if(argument == "--channel" && i + 1 < argc)
+        {
+            settings.channel_name = argv[++i];
+        }
+        else
+        {
+            path = argv[i];
+        }
+    }
+    if(path == nullptr || !(settings.speed > 0))
+    {
+        std::cerr << "Usage:\n";
+        std::cerr << "  " << argv[0] << " [--fast | --speed <factor>] [--threads <count>] [--channel <channel name>]"
+                  << " <trace file>\n";
+        return EXIT_FAILURE;
+    }
+
+    std::vector<Request> requests;
+    try
+    {
+        TraceReader reader(path);
+        for(Request request; reader.next(request);)
+        {
+            requests.push_back(request);
+        }
+        if(requests.empty())
+        {
+            std::cerr << "File " << path << " contains no requests.\n";
+            return EXIT_FAILURE;
+        }
+        return replay(requests, settings);
+    }
+    catch(std::exception const& e)
+    {
+        std::cerr << e.what() << "\n";
+        return EXIT_FAILURE;
+    }
+}
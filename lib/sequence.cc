@@ -1,49 +1,386 @@
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <cstddef>
 #include <cstdlib>
-#include <fstream>
-#include <iomanip>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
 #include <vector>
 
-#include "Polynomial.hh"
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "Allocations.hh"
+#include "Budget.hh"
+#include "Distribution.hh"
+#include "Input.hh"
+#include "Metrics.hh"
+#include "Pipeline.hh"
+#include "Processing.hh"
+#include "Server.hh"
+#include "Trace.hh"
+
+/******************************************************************************
+ * Parse a number of bytes, optionally followed by `K`, `M` or `G` (for
+ * kibibytes, mebibytes or gibibytes).
+ *
+ * @param str
+ *
+ * @return Number of bytes.
+ *****************************************************************************/
+static std::size_t parse_size(char const* str)
+{
+    char* end;
+    double size = std::strtod(str, &end);
+    switch(*end)
+    {
+        case 'G':
+            size *= 1024;
+            [[fallthrough]];
+        case 'M':
+            size *= 1024;
+            [[fallthrough]];
+        case 'K':
+            size *= 1024;
+            break;
+    }
+    return size > 0 ? static_cast<std::size_t>(size) : 0;
+}
+
+/******************************************************************************
+ * Display how much memory the computations were estimated to need, if there
+ * was a budget.
+ *
+ * @param budget
+ *****************************************************************************/
+static void report(Budget& budget)
+{
+    if(budget.capacity() == std::numeric_limits<std::size_t>::max())
+    {
+        return;
+    }
+    std::cerr << "Memory: " << budget.peak_usage() << " bytes at peak of a budget of " << budget.capacity()
+              << " bytes; " << budget.waits() << " sets waited and " << budget.rejections() << " were rejected.\n";
+}
 
 /******************************************************************************
- * Main function.
+ * Process the sets of points in a file one after the other, each as soon as
+ * it has been read. If any set fails, the status of the first failure is
+ * returned, but the remaining sets are still processed.
+ *
+ * @param path Input file. `-` is standard input.
+ * @param options
+ * @param budget
+ *
+ * @return Exit status.
+ *****************************************************************************/
+static int run(char const* path, Options const& options, Budget& budget)
+{
+    int fd = (std::string(path) == "-") ? STDIN_FILENO : open(path, O_RDONLY);
+    if(fd == -1)
+    {
+        std::cerr << "File " << path << " could not be read.\n";
+        return EXIT_FAILURE;
+    }
+    int status = EXIT_SUCCESS;
+    Stream stream(fd);
+    char const* begin;
+    char const* end;
+    try
+    {
+        for(std::size_t set = 1; stream.next(begin, end); ++set)
+        {
+            if(set > 1)
+            {
+                std::cout << "\n";
+            }
+            Points points;
+            int set_status = parse_set(begin, end, set, options, points, std::cerr);
+            if(set_status == EXIT_SUCCESS)
+            {
+                std::size_t memory = estimate(points, options).memory;
+                set_status = admit(points, memory, set, options, budget, std::cout, std::cerr);
+            }
+            std::cout.flush();
+            if(status == EXIT_SUCCESS)
+            {
+                status = set_status;
+            }
+        }
+    }
+    catch(std::runtime_error const& e)
+    {
+        std::cerr << e.what() << "\n";
+        status = EXIT_FAILURE;
+    }
+    if(fd != STDIN_FILENO)
+    {
+        close(fd);
+    }
+    return status;
+}
+
+/******************************************************************************
+ * Main function. The input may contain several sets of points, separated by
+ * blank lines. Each is processed as soon as it has been read, so that this
+ * program can sit in a pipeline. In batch mode, several input files are
+ * processed concurrently; see `batch`.
  *****************************************************************************/
 int main(int const argc, char const* argv[])
 {
-    if(argc < 2)
+    // Options may appear anywhere. Of the remaining arguments, the first is
+    // the input file (or `-` for standard input), and the presence of a
+    // second requests rational output. In batch mode, all of them are input
+    // files.
+    std::vector<char const*> arguments;
+    Options options;
+    char const* queries_path = nullptr;
+    bool batch_mode = false;
+    std::size_t memory_budget = 0;
+    char const* channel_name = nullptr;
+    std::size_t num_of_workers = 0;
+    char const* metrics_path = nullptr;
+    char const* trace_path = nullptr;
+    double metrics_interval = 1;
+    std::size_t num_of_slots = 64, slot_capacity = 1 << 16;
+    Pipeline pipeline;
+    pipeline.num_of_threads = std::max(std::thread::hardware_concurrency(), 1U);
+    for(int i = 1; i < argc; ++i)
     {
-        std::cerr << "Usage:\n";
-        std::cerr << "  " << argv[0] << " <input file>\n";
+        std::string argument = argv[i];
+        if(argument == "--timeout" && i + 1 < argc)
+        {
+            options.timeout = std::strtod(argv[++i], nullptr);
+        }
+        else if(argument == "--queries" && i + 1 < argc)
+        {
+            queries_path = argv[++i];
+        }
+        else if(argument == "--y-only")
+        {
+            options.y_only = true;
+        }
+        else if(argument == "--start" && i + 1 < argc)
+        {
+            options.start = std::strtod(argv[++i], nullptr);
+        }
+        else if(argument == "--step" && i + 1 < argc)
+        {
+            options.step = std::strtod(argv[++i], nullptr);
+        }
+        else if(argument == "--rational")
+        {
+            options.rational = true;
+        }
+        else if(argument == "--precision" && i + 1 < argc)
+        {
+            options.precision = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if(argument == "--extended")
+        {
+            options.extended = true;
+        }
+        else if(argument == "--refine" && i + 1 < argc)
+        {
+            options.refinements = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if(argument == "--batch")
+        {
+            batch_mode = true;
+        }
+        else if(argument == "--depth" && i + 1 < argc)
+        {
+            pipeline.depth = std::max(std::strtoull(argv[++i], nullptr, 10), 1ULL);
+        }
+        else if(argument == "--threads" && i + 1 < argc)
+        {
+            pipeline.num_of_threads = std::max(std::strtoull(argv[++i], nullptr, 10), 1ULL);
+        }
+        else if(argument == "--aging" && i + 1 < argc)
+        {
+            pipeline.aging = std::max(std::strtod(argv[++i], nullptr), 0.0);
+        }
+        else if(argument == "--memory-budget" && i + 1 < argc)
+        {
+            memory_budget = parse_size(argv[++i]);
+        }
+        else if(argument == "--coalesce" && i + 1 < argc)
+        {
+            pipeline.coalesce = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if(argument == "--coalesce-window" && i + 1 < argc)
+        {
+            pipeline.window = std::chrono::microseconds(std::strtoull(argv[++i], nullptr, 10));
+        }
+        else if(argument == "--workers" && i + 1 < argc)
+        {
+            num_of_workers = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if(argument == "--record" && i + 1 < argc)
+        {
+            trace_path = argv[++i];
+        }
+        else if(argument == "--metrics" && i + 1 < argc)
+        {
+            metrics_path = argv[++i];
+        }
+        else if(argument == "--metrics-interval" && i + 1 < argc)
+        {
+            metrics_interval = std::strtod(argv[++i], nullptr);
+        }
+        else if(argument == "--serve" && i + 1 < argc)
+        {
+            channel_name = argv[++i];
+        }
+        else if(argument == "--slots" && i + 1 < argc)
+        {
+            num_of_slots = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if(argument == "--slot-size" && i + 1 < argc)
+        {
+            slot_capacity = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if(argument == "--unordered")
+        {
+            pipeline.ordered = false;
+        }
+        else
+        {
+            arguments.push_back(argv[i]);
+        }
+    }
+    if(std::isnan(options.timeout))
+    {
+        std::cerr << "Timeout must be a number.\n";
         return EXIT_FAILURE;
     }
-    std::ifstream input(argv[1]);
-    if(!input.good())
+    if(arguments.empty() && channel_name == nullptr)
     {
-        std::cerr << "File " << argv[1] << " could not be read.\n";
+        std::cerr << "Usage:\n";
+        std::cerr << "  " << argv[0] << " [<options>] <input file> [1]\n";
+        std::cerr << "  " << argv[0] << " --batch [--depth <capacity>] [--threads <count>] [--aging <rate>]"
+                  << " [--unordered] [--coalesce <count>] [--coalesce-window <microseconds>] [<options>]"
+                  << " <input file> [<input file> ...]\n";
+        std::cerr << "  " << argv[0] << " --batch --workers <count> [--depth <capacity>] [--unordered] [<options>]"
+                  << " <input file> [<input file> ...]\n";
+        std::cerr << "  " << argv[0] << " --serve <channel name> [--slots <count>] [--slot-size <numbers>]"
+                  << " [--threads <count>] [--timeout <seconds>]\n";
+        std::cerr << "Options:\n";
+        std::cerr << "  --rational\n";
+        std::cerr << "  --precision <bits>\n";
+        std::cerr << "  --extended\n";
+        std::cerr << "  --refine <iterations>\n";
+        std::cerr << "  --timeout <seconds>\n";
+        std::cerr << "  --queries <query file>\n";
+        std::cerr << "  --y-only [--start <x>] [--step <h>]\n";
+        std::cerr << "  --memory-budget <bytes>[K|M|G]\n";
+        std::cerr << "  --metrics <metrics file> [--metrics-interval <seconds>]\n";
+        std::cerr << "  --record <trace file>\n";
         return EXIT_FAILURE;
     }
-    bool rational = (argc >= 3);
 
-    std::vector<double> xcoords, ycoords;
-    double xcoord, ycoord;
-    while((input >> xcoord) && (input >> ycoord))
+    if(queries_path != nullptr)
     {
-        xcoords.push_back(xcoord);
-        ycoords.push_back(ycoord);
+        std::string contents;
+        if(!read_file(queries_path, contents))
+        {
+            std::cerr << "File " << queries_path << " could not be read.\n";
+            return EXIT_FAILURE;
+        }
+        try
+        {
+            parse_numbers(contents.data(), contents.data() + contents.size(), options.queries);
+        }
+        catch(std::invalid_argument const& e)
+        {
+            std::cerr << "File " << queries_path << " could not be parsed. " << e.what() << "\n";
+            return EXIT_FAILURE;
+        }
     }
-    auto begin = std::chrono::steady_clock::now();
-    Polynomial p(xcoords, ycoords);
-    auto end = std::chrono::steady_clock::now();
-    auto delay = std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count();
 
     // To display more digits after the decimal point.
     std::cout.precision(12);
 
-    p.rational = rational;
-    std::cout << "[3mp[0m ≡ " << p << "\n";
-    std::cout << "[3mp[0m(" << xcoord << ") = " << p(xcoord) << "\n";
-    std::cout << "Done in " << delay << " µs.\n";
-    return EXIT_SUCCESS;
+    std::unique_ptr<TraceWriter> trace_owner;
+    if(trace_path != nullptr)
+    {
+        try
+        {
+            trace_owner = std::make_unique<TraceWriter>(trace_path);
+        }
+        catch(std::runtime_error const& e)
+        {
+            std::cerr << e.what() << "\n";
+            return EXIT_FAILURE;
+        }
+        trace = trace_owner.get();
+    }
+
+    // The metrics are written periodically, and once more at the end.
+    std::unique_ptr<Metrics> metrics_owner;
+    if(metrics_path != nullptr)
+    {
+        metrics_owner = std::make_unique<Metrics>();
+        metrics = metrics_owner.get();
+        metrics->counter("lagrange_allocations_total", "Memory allocations made.", "",
+                         []{ return total_allocations(false); });
+        metrics->counter("lagrange_allocated_bytes_total", "Memory allocated.", "",
+                         []{ return total_allocations(true); });
+        count_allocations();
+    }
+    auto publish = [&]
+    {
+        if(metrics != nullptr)
+        {
+            metrics->publish(metrics_path, std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                               std::chrono::duration<double>(std::max(metrics_interval, 0.001))));
+        }
+    };
+
+    int status;
+    if(channel_name == nullptr && batch_mode && num_of_workers > 0)
+    {
+        status = distribute(arguments, options, pipeline, num_of_workers, memory_budget, publish);
+    }
+    else
+    {
+        publish();
+        Budget budget(memory_budget);
+        if(channel_name != nullptr)
+        {
+            status = serve(channel_name, num_of_slots, slot_capacity, options, pipeline.num_of_threads);
+        }
+        else if(batch_mode)
+        {
+            status = batch(arguments, options, pipeline, budget);
+            report(budget);
+        }
+        else
+        {
+            options.rational = options.rational || (arguments.size() >= 2);
+            status = run(arguments[0], options, budget);
+            report(budget);
+        }
+    }
+
+    // Only once the trace has been closed is it known whether all of it could
+    // be written.
+    if(trace != nullptr)
+    {
+        trace = nullptr;
+        try
+        {
+            trace_owner->close();
+        }
+        catch(std::runtime_error const& e)
+        {
+            std::cerr << e.what() << "\n";
+            status = status == EXIT_SUCCESS ? EXIT_FAILURE : status;
+        }
+    }
+    return status;
 }
@@ -0,0 +1,97 @@
+/* Test of the C interface declared in `lagrange.h` and its status codes, run
+ * by `make check` against the shared library. */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "lagrange.h"
+
+static int failures = 0;
+
+/******************************************************************************
+ * Report a check which failed.
+ *
+ * @param passed Whether the check passed.
+ * @param description What was checked.
+ *****************************************************************************/
+static void expect(int passed, char const* description)
+{
+    if(!passed)
+    {
+        fprintf(stderr, "Failed: %s.\n", description);
+        ++failures;
+    }
+}
+
+int main(void)
+{
+    /* The polynomial 1 - 2x + 3x^2. */
+    double xcoords[] = {-1, 0, 2};
+    double ycoords[] = {6, 1, 9};
+    double coefficients[3];
+    double queries[] = {1, 3};
+    double values[2];
+    size_t num_of_coefficients = 0;
+    lip_polynomial* p = NULL;
+    lip_polynomial* q = NULL;
+    size_t const num_of_points = 4096;
+    double* many_xcoords = malloc(num_of_points * sizeof *many_xcoords);
+    double* many_ycoords = malloc(num_of_points * sizeof *many_ycoords);
+    size_t i;
+
+    expect(lip_abi_version() == LIP_ABI_VERSION, "the version is that of the header");
+
+    expect(lip_interpolate(xcoords, ycoords, 3, &p) == LIP_OK, "three points are interpolated");
+    expect(lip_coefficients(p, coefficients, 3, &num_of_coefficients) == LIP_OK, "the coefficients are copied");
+    expect(num_of_coefficients == 3, "there are three coefficients");
+    expect(fabs(coefficients[0] - 1) < 1e-12 && fabs(coefficients[1] + 2) < 1e-12
+           && fabs(coefficients[2] - 3) < 1e-12, "the coefficients are 1, -2 and 3");
+    num_of_coefficients = 0;
+    expect(lip_coefficients(p, coefficients, 2, &num_of_coefficients) == LIP_ERANGE,
+           "a short buffer is reported");
+    expect(num_of_coefficients == 3, "the number of coefficients is stored for a short buffer");
+    expect(lip_eval_batch(p, queries, values, 2) == LIP_OK, "the polynomial is evaluated");
+    expect(fabs(values[0] - 2) < 1e-12 && fabs(values[1] - 22) < 1e-12, "the values are 2 and 22");
+    expect(lip_eval_batch(p, queries, queries, 2) == LIP_OK && fabs(queries[1] - 22) < 1e-12,
+           "the polynomial is evaluated in place");
+
+    expect(lip_interpolate(NULL, ycoords, 3, &q) == LIP_EINVAL, "null x-coordinates are rejected");
+    expect(lip_interpolate(xcoords, ycoords, 3, NULL) == LIP_EINVAL, "a null result is rejected");
+    expect(lip_interpolate(xcoords, ycoords, 1, &q) == LIP_EINVAL, "a single point is rejected");
+    xcoords[1] = xcoords[0];
+    expect(lip_interpolate(xcoords, ycoords, 3, &q) == LIP_EINVAL, "duplicate x-coordinates are rejected");
+    xcoords[1] = 0;
+    expect(lip_coefficients(NULL, coefficients, 3, NULL) == LIP_EINVAL, "a null polynomial is rejected");
+    expect(lip_eval_batch(p, NULL, values, 2) == LIP_EINVAL, "null queries are rejected");
+
+    expect(lip_interpolate_timeout(xcoords, ycoords, 3, NAN, &q) == LIP_EINVAL, "a timeout of NaN is rejected");
+    expect(lip_eval_batch_timeout(p, queries, values, 2, NAN) == LIP_EINVAL, "a timeout of NaN is rejected");
+    expect(lip_interpolate_timeout(xcoords, ycoords, 3, 0, &q) == LIP_OK, "a timeout of 0 means none");
+    lip_free(q);
+    expect(lip_eval_batch_timeout(p, queries, values, 2, -1) == LIP_OK, "a negative timeout means none");
+    expect(lip_interpolate_timeout(xcoords, ycoords, 3, INFINITY, &q) == LIP_OK, "an infinite timeout means none");
+    lip_free(q);
+
+    /* Chebyshev points of the first kind, so that they are distinct. */
+    for(i = 0; i < num_of_points; ++i)
+    {
+        many_xcoords[i] = cos((2 * i + 1) * acos(-1) / (2 * num_of_points));
+        many_ycoords[i] = many_xcoords[i];
+    }
+    q = NULL;
+    expect(lip_interpolate_timeout(many_xcoords, many_ycoords, num_of_points, 1e-9, &q) == LIP_ETIMEDOUT,
+           "an expired timeout is reported");
+    expect(q == NULL, "nothing is stored when the timeout expires");
+
+    lip_free(p);
+    lip_free(NULL);
+    free(many_xcoords);
+    free(many_ycoords);
+    if(failures > 0)
+    {
+        return EXIT_FAILURE;
+    }
+    printf("All checks of the C interface passed.\n");
+    return EXIT_SUCCESS;
+}